@@ -12,7 +12,13 @@
 #include <wx/dcbuffer.h>
 #include <wx/fontdlg.h>
 
+#ifdef __WXGTK3__
+    #include <wx/graphics.h>
+    #include <cairo.h>
+#endif
+
 #include "bmpfromocvpanel.h"
+#include "framestatistics.h"
 
 wxBitmapFromOpenCVPanel::wxBitmapFromOpenCVPanel(wxWindow* parent)
     : wxScrolledCanvas(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxFULL_REPAINT_ON_RESIZE)
@@ -34,16 +40,176 @@ wxBitmapFromOpenCVPanel::wxBitmapFromOpenCVPanel(wxWindow* parent)
     Bind(wxEVT_RIGHT_DCLICK, &wxBitmapFromOpenCVPanel::OnChangeOverlayFont, this);
 }
 
+wxBitmapFromOpenCVPanel::~wxBitmapFromOpenCVPanel()
+{
+#ifdef __WXGTK3__
+    if ( m_surface )
+        cairo_surface_destroy(m_surface);
+#endif
+}
+
 bool wxBitmapFromOpenCVPanel::SetBitmap(const wxBitmap& bitmap, const long timeGet, const long timeConvert)
 {
     m_bitmap = bitmap;
 
+#ifdef __WXGTK3__
+    if ( m_surface )
+    {
+        cairo_surface_destroy(m_surface);
+        m_surface = nullptr;
+    }
+#endif
+
+    UpdateVirtualSize();
+
+    m_timeGetCVBitmap = timeGet;
+    m_timeConvertBitmap = timeConvert;
+
+    // Do not Update() here, painting synchronously for every frame
+    // would stall the GUI thread when the frames come in fast.
+    Refresh();
+    return true;
+}
+
+bool wxBitmapFromOpenCVPanel::UpdateBitmap(const wxBitmap& bitmap, const std::vector<wxRect>& changedTiles,
+                                           const long timeGet, const long timeConvert)
+{
+    wxCHECK(bitmap.IsOk(), false);
+    wxCHECK(bitmap.GetSize() == GetBitmapSize(), false);
+
+    // bitmap usually shares the data with m_bitmap anyway
+    m_bitmap = bitmap;
+
+    m_timeGetCVBitmap = timeGet;
+    m_timeConvertBitmap = timeConvert;
+
+    RefreshTiles(changedTiles);
+    return true;
+}
+
+#ifdef __WXGTK3__
+
+bool wxBitmapFromOpenCVPanel::SetSurface(cairo_surface_t* surface, const long timeGet, const long timeConvert)
+{
+    wxCHECK(surface, false);
+
+    m_bitmap = wxBitmap();
+
+    if ( m_surface )
+        cairo_surface_destroy(m_surface);
+    m_surface = surface;
+
+    UpdateVirtualSize();
+
+    m_timeGetCVBitmap = timeGet;
+    m_timeConvertBitmap = timeConvert;
+
+    Refresh();
+    return true;
+}
+
+bool wxBitmapFromOpenCVPanel::UpdateSurface(const std::vector<wxRect>& changedTiles,
+                                            const long timeGet, const long timeConvert)
+{
+    wxCHECK(m_surface, false);
+
+    m_timeGetCVBitmap = timeGet;
+    m_timeConvertBitmap = timeConvert;
+
+    RefreshTiles(changedTiles);
+    return true;
+}
+
+#endif // #ifdef __WXGTK3__
+
+void wxBitmapFromOpenCVPanel::SetPresentationStats(unsigned long presented, unsigned long superseded)
+{
+    m_framesPresented = presented;
+    m_framesSuperseded = superseded;
+}
+
+void wxBitmapFromOpenCVPanel::SetIncrementalUpdateStats(double updatedFraction, double timeSavedMs)
+{
+    m_updatedFraction = updatedFraction;
+    m_timeSavedMs = timeSavedMs;
+}
+
+void wxBitmapFromOpenCVPanel::SetProcessingStats(const wxString& stats)
+{
+    m_processingStats = stats;
+}
+
+void wxBitmapFromOpenCVPanel::SetFrameStatistics(const FrameStatistics& statistics)
+{
+    m_frameStatisticsText.clear();
+    m_histogramLines.clear();
+    m_histogramColours.clear();
+
+    if ( statistics.IsEmpty() )
+        return;
+
+    m_frameStatisticsText.Printf("Statistics (%lu frames, %llu samples per channel):\n",
+        statistics.frameCount, static_cast<unsigned long long>(statistics.sampleCount));
+    m_frameStatisticsText += FormatFrameStatistics(statistics);
+
+    // The clipped values (0 and 255) are not used for scaling,
+    // otherwise they would flatten the rest of the histogram.
+    uint64_t maxCount = 1;
+
+    for ( int c = 0; c < statistics.channels; ++c )
+    {
+        for ( int v = 1; v < FrameStatistics::BinCount - 1; ++v )
+            maxCount = wxMax(maxCount, statistics.histograms[c][v]);
+    }
+
+    m_histogramSize = FromDIP(wxSize(FrameStatistics::BinCount, 64));
+
+    const int height = m_histogramSize.GetHeight();
+
+    for ( int c = 0; c < statistics.channels; ++c )
+    {
+        std::vector<wxPoint> line;
+
+        line.reserve(FrameStatistics::BinCount);
+        for ( int v = 0; v < FrameStatistics::BinCount; ++v )
+        {
+            const double scaled = static_cast<double>(statistics.histograms[c][v]) / maxCount;
+
+            line.push_back(wxPoint(v * m_histogramSize.GetWidth() / FrameStatistics::BinCount,
+                                   height - 1 - static_cast<int>(wxMin(1., scaled) * (height - 1))));
+        }
+        m_histogramLines.push_back(line);
+    }
+
+    if ( statistics.channels == 1 )
+        m_histogramColours.push_back(*wxWHITE);
+    else
+        m_histogramColours = { wxColour(64, 128, 255), wxColour(0, 224, 0), wxColour(255, 64, 64) };
+}
+
+wxSize wxBitmapFromOpenCVPanel::GetBitmapSize() const
+{
+#ifdef __WXGTK3__
+    if ( m_surface )
+        return wxSize(cairo_image_surface_get_width(m_surface), cairo_image_surface_get_height(m_surface));
+#endif
+
     if ( m_bitmap.IsOk() )
+        return m_bitmap.GetSize();
+
+    return wxDefaultSize;
+}
+
+void wxBitmapFromOpenCVPanel::UpdateVirtualSize()
+{
+    const wxSize bitmapSize = GetBitmapSize();
+
+    if ( bitmapSize != wxDefaultSize )
     {
-        if ( m_bitmap.GetSize() != GetVirtualSize() )
+        if ( bitmapSize != GetVirtualSize() )
         {
             InvalidateBestSize();
-            SetVirtualSize(m_bitmap.GetSize());
+            SetVirtualSize(bitmapSize);
         }
     }
     else
@@ -51,20 +217,26 @@ bool wxBitmapFromOpenCVPanel::SetBitmap(const wxBitmap& bitmap, const long timeG
         InvalidateBestSize();
         SetVirtualSize(1, 1);
     }
+}
 
-    m_timeGetCVBitmap = timeGet;
-    m_timeConvertBitmap = timeConvert;
+void wxBitmapFromOpenCVPanel::RefreshTiles(const std::vector<wxRect>& tiles)
+{
+    for ( const wxRect& tile : tiles )
+        RefreshRect(wxRect(CalcScrolledPosition(tile.GetTopLeft()), tile.GetSize()), false);
 
-    Refresh(); Update();
-    return true;
+    // the overlay text changes with every frame
+    if ( !m_overlayRect.IsEmpty() )
+        RefreshRect(m_overlayRect, false);
 }
 
 wxSize wxBitmapFromOpenCVPanel::DoGetBestClientSize() const
 {
-    if ( !m_bitmap.IsOk() )
+    const wxSize bitmapSize = GetBitmapSize();
+
+    if ( bitmapSize == wxDefaultSize )
         return FromDIP(wxSize(64, 48)); // completely arbitrary
 
-    return m_bitmap.GetSize();
+    return bitmapSize;
 }
 
 void wxBitmapFromOpenCVPanel::OnPaint(wxPaintEvent&)
@@ -73,7 +245,9 @@ void wxBitmapFromOpenCVPanel::OnPaint(wxPaintEvent&)
 
     dc.Clear();
 
-    if ( !m_bitmap.IsOk() )
+    const wxSize bitmapSize = GetBitmapSize();
+
+    if ( bitmapSize == wxDefaultSize )
         return;
 
     const wxSize clientSize = GetClientSize();
@@ -85,7 +259,28 @@ void wxBitmapFromOpenCVPanel::OnPaint(wxPaintEvent&)
 
     DoPrepareDC(dc);
 
-    dc.DrawBitmap(m_bitmap, 0, 0, false);
+#ifdef __WXGTK3__
+    if ( m_surface )
+    {
+        // wxGTK3 wxPaintDC is wxGCDC-based, its graphics context
+        // is already transformed by DoPrepareDC().
+        wxGraphicsContext* gc = dc.GetGraphicsContext();
+
+        wxCHECK_RET(gc, "No graphics context for wxPaintDC");
+
+        // wxGraphicsBitmap takes ownership of the native bitmap
+        // but we want to keep m_surface.
+        cairo_surface_reference(m_surface);
+
+        const wxGraphicsBitmap gcBitmap = gc->GetRenderer()->CreateBitmapFromNativeBitmap(m_surface);
+
+        gc->DrawBitmap(gcBitmap, 0, 0, bitmapSize.GetWidth(), bitmapSize.GetHeight());
+    }
+    else
+#endif
+    {
+        dc.DrawBitmap(m_bitmap, 0, 0, false);
+    }
 
     GetScrollPixelsPerUnit(&pixelsPerUnitX, &pixelsPerUnitY);
     offset.x *= pixelsPerUnitX; offset.y *= pixelsPerUnitY;
@@ -96,9 +291,52 @@ void wxBitmapFromOpenCVPanel::OnPaint(wxPaintEvent&)
     wxDCTextColourChanger textColourChanger(dc, m_overlayTextColour);
     wxDCFontChanger       fontChanger(dc, m_overlayFont);
 
-    dc.DrawText(wxString::Format("GetCVBitmap: %ld ms\nConvertCVtoWXBitmap: %ld ms\nDrawWXBitmap: %ld ms\n",
-        m_timeGetCVBitmap, m_timeConvertBitmap, drawTime),
-        offset);
+    wxString overlayText = wxString::Format("GetCVBitmap: %ld ms\nConvertCVtoWXBitmap: %ld ms\nDrawWXBitmap: %ld ms\n",
+        m_timeGetCVBitmap, m_timeConvertBitmap, drawTime);
+
+    if ( m_framesPresented != 0 || m_framesSuperseded != 0 )
+    {
+        overlayText += wxString::Format("Frames presented: %lu\nFrames superseded: %lu\n",
+            m_framesPresented, m_framesSuperseded);
+    }
+
+    if ( m_updatedFraction >= 0. )
+    {
+        overlayText += wxString::Format("Tiles updated: %.1f %%\nTime saved: %.2f ms\n",
+            m_updatedFraction * 100., m_timeSavedMs);
+    }
+
+    overlayText += m_processingStats;
+    overlayText += m_frameStatisticsText;
+
+    dc.DrawText(overlayText, offset);
+
+    wxSize overlaySize = dc.GetMultiLineTextExtent(overlayText);
+
+    // histograms below the text
+    if ( !m_histogramLines.empty() )
+    {
+        const wxPoint    histogramPos(offset.x, offset.y + overlaySize.GetHeight());
+        wxDCPenChanger   penChanger(dc, wxPen(m_overlayTextColour));
+        wxDCBrushChanger brushChanger(dc, *wxTRANSPARENT_BRUSH);
+
+        dc.DrawRectangle(histogramPos, m_histogramSize);
+
+        for ( size_t i = 0; i < m_histogramLines.size(); ++i )
+        {
+            dc.SetPen(wxPen(m_histogramColours[i]));
+            dc.DrawLines(static_cast<int>(m_histogramLines[i].size()), m_histogramLines[i].data(),
+                         histogramPos.x, histogramPos.y);
+        }
+
+        overlaySize.SetWidth(wxMax(overlaySize.GetWidth(), m_histogramSize.GetWidth()));
+        overlaySize.IncBy(0, m_histogramSize.GetHeight());
+    }
+
+    // Make the rectangle larger, so that it covers also
+    // a longer text which could be displayed for the next frame.
+    m_overlayRect = wxRect(wxPoint(0, 0), overlaySize);
+    m_overlayRect.width *= 2;
 }
 
 
@@ -10,9 +10,16 @@
 #ifndef BMPFROMOCVPANEL_H
 #define BMPFROMOCVPANEL_H
 
+#include <vector>
+
 #include <wx/wx.h>
 #include <wx/scrolwin.h>
 
+#ifdef __WXGTK3__
+typedef struct _cairo_surface cairo_surface_t;
+#endif
+
+struct FrameStatistics;
 
 // This class displays a wxBitmap originated from OpenCV
 // and also the time it took to obtain, convert, and display the bitmap.
@@ -24,17 +31,80 @@ class wxBitmapFromOpenCVPanel : public wxScrolledCanvas
 {
 public:
     wxBitmapFromOpenCVPanel(wxWindow* parent);
+    ~wxBitmapFromOpenCVPanel();
 
     bool SetBitmap(const wxBitmap& bitmap, const long timeGet, const long timeConvert);
 
+    // Like SetBitmap() but only the given tiles (in bitmap coordinates)
+    // of the bitmap have changed since it was last set, so only they
+    // are repainted. bitmap must have the same size as the displayed one.
+    bool UpdateBitmap(const wxBitmap& bitmap, const std::vector<wxRect>& changedTiles,
+                      const long timeGet, const long timeConvert);
+
+#ifdef __WXGTK3__
+    // Displays a cairo image surface (see ConvertMatBitmapToCairoSurface())
+    // instead of a wxBitmap. The panel takes ownership of the surface.
+    // The surface is drawn without any format conversion.
+    bool SetSurface(cairo_surface_t* surface, const long timeGet, const long timeConvert);
+
+    // Returns the displayed surface, owned by the panel, or nullptr.
+    cairo_surface_t* GetSurface() const { return m_surface; }
+
+    // To be called after the given tiles (in surface coordinates)
+    // of the surface returned by GetSurface() were changed,
+    // only they are repainted.
+    bool UpdateSurface(const std::vector<wxRect>& changedTiles, const long timeGet, const long timeConvert);
+#endif
+
     const wxBitmap& GetBitmap() { return m_bitmap; }
 
+    // Numbers of frames presented and of frames dropped because
+    // a newer one arrived before they could be presented.
+    // Shown in the overlay when not both 0.
+    void SetPresentationStats(unsigned long presented, unsigned long superseded);
+
+    // Fraction (0.0 - 1.0) of the bitmap updated for the last frame
+    // and the estimated time this saved compared to updating it whole.
+    // Shown in the overlay when updatedFraction is not negative.
+    void SetIncrementalUpdateStats(double updatedFraction, double timeSavedMs);
+
+    // Text describing the processing of the displayed frame,
+    // shown in the overlay when not empty.
+    void SetProcessingStats(const wxString& stats);
+
+    // Histograms and exposure statistics of the recent frames,
+    // shown in the overlay when statistics are not empty.
+    // They are expected to change at a lower rate than the frames,
+    // the histogram lines are computed here and not when painting.
+    void SetFrameStatistics(const FrameStatistics& statistics);
+
+    // Returns the size of the displayed bitmap or surface,
+    // wxDefaultSize if there is none.
+    wxSize GetBitmapSize() const;
+
 private:
     wxBitmap m_bitmap;
+#ifdef __WXGTK3__
+    cairo_surface_t* m_surface{nullptr};
+#endif
     wxColour m_overlayTextColour;
     wxFont   m_overlayFont;
     long     m_timeGetCVBitmap{0};   // time to obtain bitmap from OpenCV in ms
     long     m_timeConvertBitmap{0}; // time to convert Mat to wxBitmap in ms
+    unsigned long m_framesPresented{0};
+    unsigned long m_framesSuperseded{0};
+    double   m_updatedFraction{-1.0};
+    double   m_timeSavedMs{0.0};
+    wxString m_processingStats;
+    wxString m_frameStatisticsText;
+    // in histogram coordinates, one line for each channel
+    std::vector<std::vector<wxPoint>> m_histogramLines;
+    std::vector<wxColour> m_histogramColours;
+    wxSize   m_histogramSize;
+    wxRect   m_overlayRect;          // in client coordinates, as last painted
+
+    void UpdateVirtualSize();
+    void RefreshTiles(const std::vector<wxRect>& tiles);
 
     wxSize DoGetBestClientSize() const override;
 
@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////////////////////
 // Name:        convertmattowxbmp.cpp
-// Purpose:     Converts OpenCV bitmap (Mat) stored as BGR CVU8 to wxBitmap
+// Purpose:     Converts OpenCV bitmap (Mat) to wxBitmap and back
 // Author:      PB
 // Created:     2020-09-16
 // Copyright:   (c) 2020 PB
@@ -10,19 +10,575 @@
 #include <wx/wx.h>
 #include <wx/rawbmp.h>
 
-#include <opencv2/core/mat.hpp>
+#include <algorithm>
+#include <cstring>
+#include <vector>
 
-#include "convertmattowxbmp.h"
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
 
-#ifdef __WXMSW__
+#ifdef __WXGTK3__
+    #include <cairo.h>
+#endif
+
+#include "convertmattowxbmp.h"
 
 namespace
 {
 
+// On these platforms, the colour values in wxAlphaPixelData
+// must be premultiplied by alpha.
+#if defined(__WXMSW__) || defined(__WXOSX__)
+const bool AlphaIsPremultiplied = true;
+#else
+const bool AlphaIsPremultiplied = false;
+#endif
+
+// Precomputed data used for mapping Mat values to 8-bit wxBitmap channels.
+struct ValueMapping
+{
+    float   scale{1.0f};
+    float   offset{0.0f};
+    bool    isIdentity{true}; // only for CV_8U, no need to use lut
+    uchar   lut[256];         // only for CV_8U, when !isIdentity
+    cv::Mat colormapLUT;      // 256 x 1 CV_8UC3, empty when no colormap is used
+
+    // copied from MatBitmapConversionOptions
+    bool    flipVertically{false};
+    bool    swapRedBlue{false};
+    bool    ignoreAlpha{false};
+};
+
+bool InitValueMapping(const cv::Mat& matBitmap, const MatBitmapConversionOptions& options,
+                      ValueMapping& mapping)
+{
+    const int depth = matBitmap.depth();
+    double    scale = options.scale;
+    double    offset = options.offset;
+
+    if ( options.normalize )
+    {
+        double minVal = 0., maxVal = 0.;
+
+        cv::minMaxIdx(matBitmap.reshape(1), &minVal, &maxVal);
+        scale = maxVal > minVal ? 255. / (maxVal - minVal) : 1.;
+        offset = -minVal * scale;
+    }
+    else if ( scale == 0. )
+    {
+        if ( depth == CV_16U )
+            scale = 1. / 256.;
+        else if ( depth == CV_32F )
+            scale = 255.;
+        else
+            scale = 1.;
+    }
+
+    mapping.scale = static_cast<float>(scale);
+    mapping.offset = static_cast<float>(offset);
+    mapping.flipVertically = options.flipVertically;
+    mapping.swapRedBlue = options.swapRedBlue;
+    mapping.ignoreAlpha = options.ignoreAlpha;
+
+    if ( depth == CV_8U )
+    {
+        mapping.isIdentity = scale == 1. && offset == 0.;
+
+        if ( !mapping.isIdentity )
+        {
+            for ( int i = 0; i < 256; ++i )
+                mapping.lut[i] = cv::saturate_cast<uchar>(i * scale + offset);
+        }
+    }
+
+    if ( options.colormap >= 0 && matBitmap.channels() == 1 )
+    {
+        cv::Mat gradient(1, 256, CV_8UC1);
+
+        for ( int i = 0; i < 256; ++i )
+            gradient.at<uchar>(i) = static_cast<uchar>(i);
+
+        try
+        {
+            cv::applyColorMap(gradient, mapping.colormapLUT, options.colormap);
+        }
+        catch ( const cv::Exception& e )
+        {
+            wxLogDebug("Could not create colormap %d: %s", options.colormap, e.what());
+            return false;
+        }
+    }
+
+    return true;
+}
+
+//
+// Conversion kernels
+//
+// The conversion is split into a source pixel format (Mat type plus
+// the value mapping) and a destination layout (channel offsets and
+// pixel size of the wxBitmap raw data), both known at compile time.
+// ConvertMatToLayout() dispatches once per call to the fully
+// specialized row loop so that the compiler can inline and vectorize
+// it instead of going through wxPixelData iterator for every pixel.
+//
+
+// Value mappers: map a single channel value to 8 bits.
+
+struct IdentityMapper
+{
+    typedef uchar ValueType;
+
+    uchar operator()(uchar value) const { return value; }
+};
+
+struct LUTMapper
+{
+    typedef uchar ValueType;
+
+    explicit LUTMapper(const uchar* lut) : m_lut(lut) {}
+
+    uchar operator()(uchar value) const { return m_lut[value]; }
+
+    const uchar* m_lut;
+};
+
+template <typename T>
+struct LinearMapper
+{
+    typedef T ValueType;
+
+    LinearMapper(float scale, float offset) : m_scale(scale), m_offset(offset) {}
+
+    uchar operator()(T value) const { return cv::saturate_cast<uchar>(value * m_scale + m_offset); }
+
+    float m_scale;
+    float m_offset;
+};
+
+// Source pixel formats: read a pixel from a Mat row
+// and return its 8-bit blue, green, red, and alpha values.
+
+template <class Mapper>
+struct GraySource
+{
+    typedef typename Mapper::ValueType ValueType;
+    enum { Channels = 1 };
+
+    explicit GraySource(const Mapper& mapper) : m_mapper(mapper) {}
+
+    void Read(const ValueType* src, uchar& blue, uchar& green, uchar& red, uchar& alpha) const
+    {
+        blue = green = red = m_mapper(src[0]);
+        alpha = 255;
+    }
+
+    Mapper m_mapper;
+};
+
+template <class Mapper>
+struct GrayColormapSource
+{
+    typedef typename Mapper::ValueType ValueType;
+    enum { Channels = 1 };
+
+    GrayColormapSource(const Mapper& mapper, const cv::Vec3b* colormap)
+        : m_mapper(mapper), m_colormap(colormap)
+    {}
+
+    void Read(const ValueType* src, uchar& blue, uchar& green, uchar& red, uchar& alpha) const
+    {
+        const cv::Vec3b& bgr = m_colormap[m_mapper(src[0])];
+
+        blue  = bgr[0];
+        green = bgr[1];
+        red   = bgr[2];
+        alpha = 255;
+    }
+
+    Mapper           m_mapper;
+    const cv::Vec3b* m_colormap;
+};
+
+// BGR or BGRA (RGB or RGBA when SwapRedBlue is true), alpha is not mapped.
+// When IgnoreAlpha is true, the fourth channel is skipped and the pixel is opaque.
+template <class Mapper, int ChannelCount, bool SwapRedBlue = false, bool IgnoreAlpha = false>
+struct BGRSource
+{
+    typedef typename Mapper::ValueType ValueType;
+    enum { Channels = ChannelCount };
+
+    explicit BGRSource(const Mapper& mapper) : m_mapper(mapper) {}
+
+    void Read(const ValueType* src, uchar& blue, uchar& green, uchar& red, uchar& alpha) const
+    {
+        blue  = m_mapper(src[SwapRedBlue ? 2 : 0]);
+        green = m_mapper(src[1]);
+        red   = m_mapper(src[SwapRedBlue ? 0 : 2]);
+        alpha = Channels == 4 && !IgnoreAlpha ? cv::saturate_cast<uchar>(src[3]) : 255;
+    }
+
+    Mapper m_mapper;
+};
+
+// Destination layouts are described by the same enums as wxPixelFormat
+// (RED, GREEN, BLUE, ALPHA, and SizePixel, ALPHA being -1 when
+// there is no alpha channel), so wxPixelData formats can be used directly.
+
+template <int Offset>
+inline void WriteChannel(uchar* dst, uchar value) { dst[Offset] = value; }
+
+template <>
+inline void WriteChannel<-1>(uchar*, uchar) {}
+
+inline uchar Premultiply(uchar value, uchar alpha)
+{
+    return static_cast<uchar>((value * alpha + 127) / 255);
+}
+
+template <class Source, class Layout, bool PremultiplyAlpha>
+void ConvertRow(const Source& source, const typename Source::ValueType* src,
+                uchar* dst, size_t width)
+{
+    for ( size_t col = 0;
+          col < width;
+          ++col, src += Source::Channels, dst += Layout::SizePixel )
+    {
+        uchar blue, green, red, alpha;
+
+        source.Read(src, blue, green, red, alpha);
+
+        if ( PremultiplyAlpha )
+        {
+            blue  = Premultiply(blue, alpha);
+            green = Premultiply(green, alpha);
+            red   = Premultiply(red, alpha);
+        }
+
+        WriteChannel<Layout::BLUE>(dst, blue);
+        WriteChannel<Layout::GREEN>(dst, green);
+        WriteChannel<Layout::RED>(dst, red);
+        WriteChannel<Layout::ALPHA>(dst, alpha);
+    }
+}
+
+// Converts width x height pixels, src and dst point to the first pixel
+// of the first row, the row strides are in bytes and may be negative.
+// When Contiguous is true, there are no gaps between the rows
+// of either source or destination and the whole image
+// can be processed as a single row.
+template <class Source, class Layout, bool PremultiplyAlpha, bool Contiguous>
+void ConvertImage(const Source& source, int width, int height,
+                  const uchar* src, ptrdiff_t srcRowStride,
+                  uchar* dst, ptrdiff_t dstRowStride)
+{
+    typedef typename Source::ValueType ValueType;
+
+    if ( Contiguous )
+    {
+        ConvertRow<Source, Layout, PremultiplyAlpha>(source, reinterpret_cast<const ValueType*>(src),
+            dst, static_cast<size_t>(width) * height);
+        return;
+    }
+
+    for ( int row = 0; row < height; ++row, src += srcRowStride, dst += dstRowStride )
+    {
+        ConvertRow<Source, Layout, PremultiplyAlpha>(source, reinterpret_cast<const ValueType*>(src),
+            dst, width);
+    }
+}
+
+template <class Layout, bool PremultiplyAlpha, class Source>
+void ConvertWithSource(const Source& source, int width, int height,
+                       const uchar* src, ptrdiff_t srcRowStride,
+                       uchar* dst, ptrdiff_t dstRowStride)
+{
+    typedef typename Source::ValueType ValueType;
+
+    const bool contiguous = srcRowStride == static_cast<ptrdiff_t>(width * Source::Channels * sizeof(ValueType))
+                            && dstRowStride == static_cast<ptrdiff_t>(width) * Layout::SizePixel;
+
+    if ( contiguous )
+    {
+        ConvertImage<Source, Layout, PremultiplyAlpha, true>(source, width, height,
+            src, srcRowStride, dst, dstRowStride);
+    }
+    else
+    {
+        ConvertImage<Source, Layout, PremultiplyAlpha, false>(source, width, height,
+            src, srcRowStride, dst, dstRowStride);
+    }
+}
+
+// When flipVertically is true, the Mat rows are read from the last one.
+template <class Layout, bool PremultiplyAlpha, class Source>
+void ConvertWithSource(const cv::Mat& matBitmap, const Source& source, bool flipVertically,
+                       uchar* dst, ptrdiff_t dstRowStride)
+{
+    if ( flipVertically )
+    {
+        ConvertWithSource<Layout, PremultiplyAlpha>(source, matBitmap.cols, matBitmap.rows,
+            matBitmap.ptr(matBitmap.rows - 1), -static_cast<ptrdiff_t>(matBitmap.step), dst, dstRowStride);
+        return;
+    }
+
+    ConvertWithSource<Layout, PremultiplyAlpha>(source, matBitmap.cols, matBitmap.rows,
+        matBitmap.data, static_cast<ptrdiff_t>(matBitmap.step), dst, dstRowStride);
+}
+
+template <class Layout, bool PremultiplyAlpha, class Mapper, int ChannelCount>
+void ConvertBGRWithMapper(const cv::Mat& matBitmap, const Mapper& mapper, const ValueMapping& mapping,
+                          uchar* dst, ptrdiff_t dstRowStride)
+{
+    const bool ignoreAlpha = ChannelCount == 4 && mapping.ignoreAlpha;
+
+    if ( mapping.swapRedBlue )
+    {
+        if ( ignoreAlpha )
+        {
+            ConvertWithSource<Layout, PremultiplyAlpha>(matBitmap,
+                BGRSource<Mapper, ChannelCount, true, true>(mapper), mapping.flipVertically, dst, dstRowStride);
+        }
+        else
+        {
+            ConvertWithSource<Layout, PremultiplyAlpha>(matBitmap,
+                BGRSource<Mapper, ChannelCount, true, false>(mapper), mapping.flipVertically, dst, dstRowStride);
+        }
+    }
+    else
+    {
+        if ( ignoreAlpha )
+        {
+            ConvertWithSource<Layout, PremultiplyAlpha>(matBitmap,
+                BGRSource<Mapper, ChannelCount, false, true>(mapper), mapping.flipVertically, dst, dstRowStride);
+        }
+        else
+        {
+            ConvertWithSource<Layout, PremultiplyAlpha>(matBitmap,
+                BGRSource<Mapper, ChannelCount, false, false>(mapper), mapping.flipVertically, dst, dstRowStride);
+        }
+    }
+}
+
+template <class Layout, bool PremultiplyAlpha, class Mapper>
+void ConvertWithMapper(const cv::Mat& matBitmap, const Mapper& mapper, const ValueMapping& mapping,
+                       uchar* dst, ptrdiff_t dstRowStride)
+{
+    switch ( matBitmap.channels() )
+    {
+        case 1:
+            if ( !mapping.colormapLUT.empty() )
+            {
+                ConvertWithSource<Layout, PremultiplyAlpha>(matBitmap,
+                    GrayColormapSource<Mapper>(mapper, mapping.colormapLUT.ptr<cv::Vec3b>()),
+                    mapping.flipVertically, dst, dstRowStride);
+            }
+            else
+            {
+                ConvertWithSource<Layout, PremultiplyAlpha>(matBitmap,
+                    GraySource<Mapper>(mapper), mapping.flipVertically, dst, dstRowStride);
+            }
+            break;
+        case 3:
+            ConvertBGRWithMapper<Layout, PremultiplyAlpha, Mapper, 3>(matBitmap, mapper, mapping, dst, dstRowStride);
+            break;
+        case 4:
+            ConvertBGRWithMapper<Layout, PremultiplyAlpha, Mapper, 4>(matBitmap, mapper, mapping, dst, dstRowStride);
+            break;
+        default:
+            wxFAIL_MSG("Unsupported number of channels");
+    }
+}
+
+// Converts matBitmap to the destination with given layout.
+// dst points to the first pixel of the first row, dstRowStride
+// is the distance in bytes between two rows and may be negative.
+// matBitmap type must be one of the types supported by ConvertMatBitmapTowxBitmap().
+template <class Layout, bool PremultiplyAlpha>
+void ConvertMatToLayout(const cv::Mat& matBitmap, const ValueMapping& mapping,
+                        uchar* dst, ptrdiff_t dstRowStride)
+{
+    switch ( matBitmap.depth() )
+    {
+        case CV_8U:
+            if ( mapping.isIdentity )
+                ConvertWithMapper<Layout, PremultiplyAlpha>(matBitmap, IdentityMapper(), mapping, dst, dstRowStride);
+            else
+                ConvertWithMapper<Layout, PremultiplyAlpha>(matBitmap, LUTMapper(mapping.lut), mapping, dst, dstRowStride);
+            break;
+        case CV_16U:
+            ConvertWithMapper<Layout, PremultiplyAlpha>(matBitmap,
+                LinearMapper<ushort>(mapping.scale, mapping.offset), mapping, dst, dstRowStride);
+            break;
+        case CV_32F:
+            ConvertWithMapper<Layout, PremultiplyAlpha>(matBitmap,
+                LinearMapper<float>(mapping.scale, mapping.offset), mapping, dst, dstRowStride);
+            break;
+        default:
+            wxFAIL_MSG("Unsupported Mat depth");
+    }
+}
+
+// Converts the whole matBitmap when tiles is nullptr, otherwise
+// only the given tiles, dst then still points to the first pixel
+// of the first row of the whole destination.
+template <class Layout, bool PremultiplyAlpha>
+void ConvertMatTilesToLayout(const cv::Mat& matBitmap, const std::vector<wxRect>* tiles,
+                             const ValueMapping& mapping, uchar* dst, ptrdiff_t dstRowStride)
+{
+    if ( !tiles )
+    {
+        ConvertMatToLayout<Layout, PremultiplyAlpha>(matBitmap, mapping, dst, dstRowStride);
+        return;
+    }
+
+    for ( const wxRect& tile : *tiles )
+    {
+        // the tiles are in image coordinates
+        const int matY = mapping.flipVertically ? matBitmap.rows - tile.y - tile.height : tile.y;
+
+        ConvertMatToLayout<Layout, PremultiplyAlpha>(matBitmap(cv::Rect(tile.x, matY, tile.width, tile.height)),
+            mapping, dst + tile.y * dstRowStride + tile.x * Layout::SizePixel, dstRowStride);
+    }
+}
+
+bool AreTilesInMatBitmap(const cv::Mat& matBitmap, const std::vector<wxRect>& tiles)
+{
+    const wxRect matRect(0, 0, matBitmap.cols, matBitmap.rows);
+
+    for ( const wxRect& tile : tiles )
+    {
+        if ( tile.IsEmpty() || !matRect.Contains(tile) )
+            return false;
+    }
+
+    return true;
+}
+
+// Returns true if any value in the given rectangle
+// differs by more than threshold between the two Mats.
+bool IsMatRectChanged(const cv::Mat& matBitmap, const cv::Mat& previousMatBitmap,
+                      const cv::Rect& rect, double threshold)
+{
+    if ( threshold > 0. )
+    {
+        // cv::norm() is vectorized for all supported depths
+        return cv::norm(matBitmap(rect), previousMatBitmap(rect), cv::NORM_INF) > threshold;
+    }
+
+    // memcmp() is vectorized as well and stops at the first difference,
+    // which for a changed tile is usually found very early
+    const size_t rowSize = rect.width * matBitmap.elemSize();
+    const size_t xOffset = rect.x * matBitmap.elemSize();
+
+    for ( int row = rect.y; row < rect.y + rect.height; ++row )
+    {
+        if ( std::memcmp(matBitmap.ptr(row) + xOffset, previousMatBitmap.ptr(row) + xOffset, rowSize) != 0 )
+            return true;
+    }
+
+    return false;
+}
+
+// Reverse conversion: the source is raw data described by a layout
+// with wxPixelFormat enums, the destination is a Mat.
+
+template <int Offset>
+inline uchar ReadChannel(const uchar* src) { return src[Offset]; }
+
+template <>
+inline uchar ReadChannel<-1>(const uchar*) { return 255; }
+
+inline uchar Unpremultiply(uchar value, uchar alpha)
+{
+    if ( alpha == 0 )
+        return 0;
+
+    return static_cast<uchar>(std::min(255, (value * 255 + alpha / 2) / alpha));
+}
+
+template <class Layout, bool UnpremultiplyAlpha>
+struct LayoutSource
+{
+    typedef uchar ValueType;
+    enum { Channels = Layout::SizePixel };
+
+    void Read(const uchar* src, uchar& blue, uchar& green, uchar& red, uchar& alpha) const
+    {
+        blue  = ReadChannel<Layout::BLUE>(src);
+        green = ReadChannel<Layout::GREEN>(src);
+        red   = ReadChannel<Layout::RED>(src);
+        alpha = ReadChannel<Layout::ALPHA>(src);
+
+        if ( UnpremultiplyAlpha )
+        {
+            blue  = Unpremultiply(blue, alpha);
+            green = Unpremultiply(green, alpha);
+            red   = Unpremultiply(red, alpha);
+        }
+    }
+};
+
+struct MatBGRPixelFormat
+{
+    enum { RED = 2, GREEN = 1, BLUE = 0, ALPHA = -1 };
+    enum { SizePixel = 3 };
+};
+
+struct MatBGRAPixelFormat
+{
+    enum { RED = 2, GREEN = 1, BLUE = 0, ALPHA = 3 };
+    enum { SizePixel = 4 };
+};
+
+// wxImage stores RGB data and alpha in separate buffers.
+struct ImageRGBPixelFormat
+{
+    enum { RED = 0, GREEN = 1, BLUE = 2, ALPHA = -1 };
+    enum { SizePixel = 3 };
+};
+
+// Converts the source data into matBitmap, which must be already
+// allocated with the right size and type (CV_8UC3 or CV_8UC4).
+template <class SrcLayout, bool UnpremultiplyAlpha>
+void ConvertLayoutToMat(const uchar* src, ptrdiff_t srcRowStride, cv::Mat& matBitmap)
+{
+    const LayoutSource<SrcLayout, UnpremultiplyAlpha> source;
+
+    if ( matBitmap.channels() == 4 )
+    {
+        ConvertWithSource<MatBGRAPixelFormat, false>(source, matBitmap.cols, matBitmap.rows,
+            src, srcRowStride, matBitmap.data, static_cast<ptrdiff_t>(matBitmap.step));
+    }
+    else
+    {
+        ConvertWithSource<MatBGRPixelFormat, false>(source, matBitmap.cols, matBitmap.rows,
+            src, srcRowStride, matBitmap.data, static_cast<ptrdiff_t>(matBitmap.step));
+    }
+}
+
+#ifdef __WXGTK3__
+
+// CAIRO_FORMAT_ARGB32 and CAIRO_FORMAT_RGB24 store a pixel as a native-endian
+// 32-bit value with alpha (unused for RGB24) in the upper 8 bits.
+struct CairoPixelFormat
+{
+#ifdef WORDS_BIGENDIAN
+    enum { RED = 1, GREEN = 2, BLUE = 3, ALPHA = 0 };
+#else
+    enum { RED = 2, GREEN = 1, BLUE = 0, ALPHA = 3 };
+#endif
+    enum { SizePixel = 4 };
+};
+
+#endif // #ifdef __WXGTK3__
+
+#ifdef __WXMSW__
+
 // Version optimized for Microsoft Windows.
 // matBitmap must be continous and matBitmap.cols % 4 must equal 0
 // as SetDIBits() requires the DIB rows to be DWORD-aligned.
-// Should not be called directly but only from ConvertMatBitmapTowxBitmap()
+// Should not be called directly but only from DoConvertMatBitmapTowxBitmap()
 // which does all the necessary debug checks.
 bool ConvertMatBitmapTowxBitmapMSW(const cv::Mat& matBitmap, wxBitmap& bitmap)
 {
@@ -44,22 +600,39 @@ bool ConvertMatBitmapTowxBitmapMSW(const cv::Mat& matBitmap, wxBitmap& bitmap)
     return success;
 }
 
-} // unnamed namespace
-
 #endif // #ifndef __WXMSW__
 
-// See the function description in the header file.
-bool ConvertMatBitmapTowxBitmap(const cv::Mat& matBitmap, wxBitmap& bitmap)
+// Converts the whole matBitmap when tiles is nullptr, only the given tiles otherwise.
+bool DoConvertMatBitmapTowxBitmap(const cv::Mat& matBitmap, wxBitmap& bitmap,
+                                  const std::vector<wxRect>* tiles,
+                                  const MatBitmapConversionOptions& options)
 {
+    const int matBitmapType = matBitmap.type();
+
     wxCHECK(!matBitmap.empty(), false);
-    wxCHECK(matBitmap.type() == CV_8UC3, false);
+    wxCHECK(GetwxBitmapDepthForMatBitmap(matBitmap) != 0, false);
     wxCHECK(matBitmap.dims == 2, false);
     wxCHECK(bitmap.IsOk(), false);
     wxCHECK(bitmap.GetWidth() == matBitmap.cols && bitmap.GetHeight() == matBitmap.rows, false);
-    wxCHECK(bitmap.GetDepth() == 24, false);
+    wxCHECK(bitmap.GetDepth() == GetwxBitmapDepthForMatBitmap(matBitmap, options)
+            || (matBitmapType == CV_8UC4 && bitmap.GetDepth() == 24), false);
+    wxCHECK(!tiles || AreTilesInMatBitmap(matBitmap, *tiles), false);
+
+    if ( tiles && tiles->empty() )
+        return true;
+
+    ValueMapping mapping;
+
+    if ( !InitValueMapping(matBitmap, options, mapping) )
+        return false;
 
 #ifdef __WXMSW__
-    if (  bitmap.IsDIB()
+    if (  !tiles
+          && matBitmapType == CV_8UC3
+          && mapping.isIdentity
+          && !mapping.flipVertically
+          && !mapping.swapRedBlue
+          && bitmap.IsDIB()
           && matBitmap.isContinuous()
           && matBitmap.cols % 4 == 0 )
     {
@@ -67,45 +640,306 @@ bool ConvertMatBitmapTowxBitmap(const cv::Mat& matBitmap, wxBitmap& bitmap)
     }
 #endif
 
-    wxNativePixelData           pixelData(bitmap);
-    wxNativePixelData::Iterator pixelDataIt(pixelData);
+    if ( bitmap.GetDepth() == 32 )
+    {
+        wxAlphaPixelData pixelData(bitmap);
+
+        wxCHECK(pixelData, false);
 
-    if ( matBitmap.isContinuous() )
+        wxAlphaPixelData::Iterator pixelDataIt(pixelData);
+
+        ConvertMatTilesToLayout<wxAlphaPixelFormat, AlphaIsPremultiplied>(matBitmap, tiles, mapping,
+            pixelDataIt.m_ptr, pixelData.GetRowStride());
+    }
+    else
+    {
+        wxNativePixelData pixelData(bitmap);
+
+        wxCHECK(pixelData, false);
+
+        wxNativePixelData::Iterator pixelDataIt(pixelData);
+
+        ConvertMatTilesToLayout<wxNativePixelFormat, false>(matBitmap, tiles, mapping,
+            pixelDataIt.m_ptr, pixelData.GetRowStride());
+    }
+
+    return bitmap.IsOk();
+}
+
+} // unnamed namespace
+
+// See the function description in the header file.
+int GetwxBitmapDepthForMatBitmap(const cv::Mat& matBitmap, const MatBitmapConversionOptions& options)
+{
+    switch ( matBitmap.type() )
     {
-        const uchar* bgr = matBitmap.data;
+        case CV_8UC4:
+            return options.ignoreAlpha ? 24 : 32;
+        case CV_8UC1:
+        case CV_8UC3:
+        case CV_16UC1:
+        case CV_16UC3:
+        case CV_32FC1:
+        case CV_32FC3:
+            return 24;
+    }
+
+    return 0;
+}
+
+// See the function description in the header file.
+bool ConvertMatBitmapTowxBitmap(const cv::Mat& matBitmap, wxBitmap& bitmap,
+                                const MatBitmapConversionOptions& options)
+{
+    return DoConvertMatBitmapTowxBitmap(matBitmap, bitmap, nullptr, options);
+}
 
-        for ( int row = 0; row < pixelData.GetHeight(); ++row )
+// See the function description in the header file.
+bool ConvertMatBitmapTowxBitmap(const cv::Mat& matBitmap, wxBitmap& bitmap,
+                                const std::vector<wxRect>& tiles,
+                                const MatBitmapConversionOptions& options)
+{
+    return DoConvertMatBitmapTowxBitmap(matBitmap, bitmap, &tiles, options);
+}
+
+// See the function description in the header file.
+bool ConvertMatBitmapTowxImage(const cv::Mat& matBitmap, wxImage& image,
+                               const MatBitmapConversionOptions& options)
+{
+    wxCHECK(!matBitmap.empty(), false);
+    wxCHECK(GetwxBitmapDepthForMatBitmap(matBitmap) != 0, false);
+    wxCHECK(matBitmap.dims == 2, false);
+    wxCHECK(image.IsOk(), false);
+    wxCHECK(image.GetWidth() == matBitmap.cols && image.GetHeight() == matBitmap.rows, false);
+
+    ValueMapping mapping;
+
+    if ( !InitValueMapping(matBitmap, options, mapping) )
+        return false;
+
+    ConvertMatToLayout<ImageRGBPixelFormat, false>(matBitmap, mapping,
+        image.GetData(), static_cast<ptrdiff_t>(matBitmap.cols) * 3);
+
+    if ( matBitmap.type() == CV_8UC4 && !options.ignoreAlpha )
+    {
+        if ( !image.HasAlpha() )
+            image.SetAlpha();
+
+        uchar* alpha = image.GetAlpha();
+
+        for ( int row = 0; row < matBitmap.rows; ++row )
         {
-            pixelDataIt.MoveTo(pixelData, 0, row);
+            const uchar* bgra = matBitmap.ptr<uchar>(options.flipVertically ? matBitmap.rows - 1 - row : row);
 
-            for ( int col = 0;
-                  col < pixelData.GetWidth();
-                  ++col, ++pixelDataIt )
-            {
-                pixelDataIt.Blue()  = *bgr++;
-                pixelDataIt.Green() = *bgr++;
-                pixelDataIt.Red()   = *bgr++;
-            }
+            for ( int col = 0; col < matBitmap.cols; ++col, bgra += 4 )
+                *alpha++ = bgra[3];
+        }
+    }
+
+    return true;
+}
+
+// See the function description in the header file.
+bool ConvertwxBitmapToMatBitmap(const wxBitmap& bitmap, cv::Mat& matBitmap)
+{
+    wxCHECK(bitmap.IsOk(), false);
+
+    // wxPixelData needs a non-const bitmap, the copy shares the data.
+    wxBitmap bmp(bitmap);
+
+    if ( bmp.HasAlpha() )
+    {
+        wxAlphaPixelData pixelData(bmp);
+
+        wxCHECK(pixelData, false);
+
+        wxAlphaPixelData::Iterator pixelDataIt(pixelData);
+
+        matBitmap.create(bmp.GetHeight(), bmp.GetWidth(), CV_8UC4);
+        ConvertLayoutToMat<wxAlphaPixelFormat, AlphaIsPremultiplied>(pixelDataIt.m_ptr,
+            pixelData.GetRowStride(), matBitmap);
+        return true;
+    }
+
+    if ( bmp.GetDepth() == 24 || bmp.GetDepth() == wxNativePixelFormat::BitsPerPixel )
+    {
+        wxNativePixelData pixelData(bmp);
+
+        if ( pixelData )
+        {
+            wxNativePixelData::Iterator pixelDataIt(pixelData);
+
+            matBitmap.create(bmp.GetHeight(), bmp.GetWidth(), CV_8UC3);
+            ConvertLayoutToMat<wxNativePixelFormat, false>(pixelDataIt.m_ptr,
+                pixelData.GetRowStride(), matBitmap);
+            return true;
         }
     }
-    else // Is it even possible for Mat with image to be not continous?
+
+    // Bitmaps with other depths (e.g., monochrome) cannot be accessed
+    // directly, let wxWidgets convert them.
+    return ConvertwxImageToMatBitmap(bmp.ConvertToImage(), matBitmap);
+}
+
+// See the function description in the header file.
+bool ConvertwxImageToMatBitmap(const wxImage& image, cv::Mat& matBitmap, bool shareRGBData)
+{
+    wxCHECK(image.IsOk(), false);
+
+    const int    width = image.GetWidth();
+    const int    height = image.GetHeight();
+    const uchar* rgb = image.GetData();
+
+    if ( !image.HasAlpha() )
+    {
+        if ( shareRGBData )
+        {
+            matBitmap = cv::Mat(height, width, CV_8UC3, image.GetData());
+            return true;
+        }
+
+        matBitmap.create(height, width, CV_8UC3);
+        ConvertLayoutToMat<ImageRGBPixelFormat, false>(rgb, static_cast<ptrdiff_t>(width) * 3, matBitmap);
+        return true;
+    }
+
+    // RGB and alpha are stored in separate buffers, so the data
+    // can be neither shared nor processed by the row kernels.
+    const uchar* alpha = image.GetAlpha();
+
+    matBitmap.create(height, width, CV_8UC4);
+
+    for ( int row = 0; row < height; ++row )
+    {
+        uchar* bgra = matBitmap.ptr<uchar>(row);
+
+        for ( int col = 0; col < width; ++col, rgb += 3, bgra += 4 )
+        {
+            bgra[0] = rgb[2];
+            bgra[1] = rgb[1];
+            bgra[2] = rgb[0];
+            bgra[3] = *alpha++;
+        }
+    }
+
+    return true;
+}
+
+// See the function description in the header file.
+bool GetChangedMatBitmapTiles(const cv::Mat& matBitmap, const cv::Mat& previousMatBitmap,
+                              int tileSize, double threshold, std::vector<wxRect>& tiles)
+{
+    wxCHECK(!matBitmap.empty(), false);
+    wxCHECK(matBitmap.dims == 2, false);
+    wxCHECK(matBitmap.size() == previousMatBitmap.size()
+            && matBitmap.type() == previousMatBitmap.type(), false);
+    wxCHECK(tileSize > 0, false);
+
+    tiles.clear();
+
+    for ( int y = 0; y < matBitmap.rows; y += tileSize )
     {
-        auto matBitmapIt = matBitmap.begin<cv::Vec3b>();
+        const int height = std::min(tileSize, matBitmap.rows - y);
+        wxRect    run; // horizontally adjacent changed tiles are merged
 
-        for ( int row = 0; row < pixelData.GetHeight(); ++row )
+        for ( int x = 0; x < matBitmap.cols; x += tileSize )
         {
-            pixelDataIt.MoveTo(pixelData, 0, row);
+            const cv::Rect tile(x, y, std::min(tileSize, matBitmap.cols - x), height);
+
+            if ( !IsMatRectChanged(matBitmap, previousMatBitmap, tile, threshold) )
+                continue;
 
-            for ( int col = 0;
-                  col < pixelData.GetWidth();
-                  ++col, ++pixelDataIt, ++matBitmapIt )
+            if ( !run.IsEmpty() && run.GetRight() + 1 == x )
             {
-                pixelDataIt.Blue()  = (*matBitmapIt)[0];
-                pixelDataIt.Green() = (*matBitmapIt)[1];
-                pixelDataIt.Red()   = (*matBitmapIt)[2];
+                run.width += tile.width;
+            }
+            else
+            {
+                if ( !run.IsEmpty() )
+                    tiles.push_back(run);
+                run = wxRect(tile.x, tile.y, tile.width, tile.height);
             }
         }
+
+        if ( !run.IsEmpty() )
+            tiles.push_back(run);
     }
 
-    return bitmap.IsOk();
-}
\ No newline at end of file
+    return true;
+}
+
+#ifdef __WXGTK3__
+
+namespace
+{
+
+// Converts the whole matBitmap when tiles is nullptr, only the given tiles otherwise.
+bool DoConvertMatBitmapToCairoSurface(const cv::Mat& matBitmap, cairo_surface_t* surface,
+                                      const std::vector<wxRect>* tiles,
+                                      const MatBitmapConversionOptions& options)
+{
+    wxCHECK(!matBitmap.empty(), false);
+    wxCHECK(GetwxBitmapDepthForMatBitmap(matBitmap) != 0, false);
+    wxCHECK(matBitmap.dims == 2, false);
+    wxCHECK(surface && cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS, false);
+    wxCHECK(cairo_surface_get_type(surface) == CAIRO_SURFACE_TYPE_IMAGE, false);
+    wxCHECK(cairo_image_surface_get_width(surface) == matBitmap.cols
+            && cairo_image_surface_get_height(surface) == matBitmap.rows, false);
+
+    const cairo_format_t format = cairo_image_surface_get_format(surface);
+
+    wxCHECK(format == CAIRO_FORMAT_RGB24 || format == CAIRO_FORMAT_ARGB32, false);
+    wxCHECK(!tiles || AreTilesInMatBitmap(matBitmap, *tiles), false);
+
+    if ( tiles && tiles->empty() )
+        return true;
+
+    ValueMapping mapping;
+
+    if ( !InitValueMapping(matBitmap, options, mapping) )
+        return false;
+
+    cairo_surface_flush(surface);
+
+    uchar*          data = cairo_image_surface_get_data(surface);
+    const ptrdiff_t rowStride = cairo_image_surface_get_stride(surface);
+
+    wxCHECK(data, false);
+
+    // Only Mats with alpha need premultiplying, for the others alpha is always 255.
+    if ( format == CAIRO_FORMAT_ARGB32 && matBitmap.type() == CV_8UC4 && !options.ignoreAlpha )
+        ConvertMatTilesToLayout<CairoPixelFormat, true>(matBitmap, tiles, mapping, data, rowStride);
+    else
+        ConvertMatTilesToLayout<CairoPixelFormat, false>(matBitmap, tiles, mapping, data, rowStride);
+
+    if ( tiles )
+    {
+        for ( const wxRect& tile : *tiles )
+            cairo_surface_mark_dirty_rectangle(surface, tile.x, tile.y, tile.width, tile.height);
+    }
+    else
+    {
+        cairo_surface_mark_dirty(surface);
+    }
+
+    return true;
+}
+
+} // unnamed namespace
+
+// See the function description in the header file.
+bool ConvertMatBitmapToCairoSurface(const cv::Mat& matBitmap, cairo_surface_t* surface,
+                                    const MatBitmapConversionOptions& options)
+{
+    return DoConvertMatBitmapToCairoSurface(matBitmap, surface, nullptr, options);
+}
+
+// See the function description in the header file.
+bool ConvertMatBitmapToCairoSurface(const cv::Mat& matBitmap, cairo_surface_t* surface,
+                                    const std::vector<wxRect>& tiles,
+                                    const MatBitmapConversionOptions& options)
+{
+    return DoConvertMatBitmapToCairoSurface(matBitmap, surface, &tiles, options);
+}
+
+#endif // #ifdef __WXGTK3__
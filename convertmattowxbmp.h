@@ -1,6 +1,6 @@
 ///////////////////////////////////////////////////////////////////////////////
 // Name:        convertmattowxbmp.h
-// Purpose:     Converts OpenCV bitmap (Mat) stored as BGR CVU8 to wxBitmap
+// Purpose:     Converts OpenCV bitmap (Mat) to wxBitmap and back
 // Author:      PB
 // Created:     2020-09-16
 // Copyright:   (c) 2020 PB
@@ -11,17 +11,88 @@
 #ifndef CONVERTMATTOWXBMP_H
 #define CONVERTMATTOWXBMP_H
 
+#include <vector>
+
+#include <wx/defs.h>
+#include <wx/gdicmn.h>
+
 // forward declarations
 namespace cv { class Mat; }
 class wxBitmap;
+class wxImage;
+
+#ifdef __WXGTK3__
+typedef struct _cairo_surface cairo_surface_t;
+#endif
+
+/**
+    Describes how are the values stored in a Mat mapped
+    to 8-bit wxBitmap channels.
+
+    The mapping is done in the same pass as the conversion,
+    i.e., there is no need to convertTo() or applyColorMap()
+    into a temporary Mat first.
+*/
+struct MatBitmapConversionOptions
+{
+    // Each colour channel value is converted as
+    // saturate_cast<uchar>(value * scale + offset).
+    // When scale is 0, the default for the Mat depth is used:
+    // 1 for CV_8U, 1/256 for CV_16U (i.e., [0, 65535] -> [0, 255]),
+    // and 255 for CV_32F (i.e., [0.0, 1.0] -> [0, 255]).
+    double scale{0.0};
+    double offset{0.0};
+
+    // If true, scale and offset are ignored and computed instead
+    // so that the minimum and maximum values found in the Mat
+    // are mapped to 0 and 255. For CV_8UC4, the alpha channel is
+    // included when searching for the minimum and maximum.
+    bool   normalize{false};
+
+    // One of cv::ColormapTypes or -1 when no colormap is to be used.
+    // Applied only to single-channel Mats, after scaling.
+    int    colormap{-1};
+
+    // The following options describe Mats wrapping data stored
+    // in a layout different from the usual OpenCV one, e.g.,
+    // a memory-mapped image file (see MappedImage), so that
+    // such data can be converted directly, without copying them first.
+
+    // The rows are stored bottom-up, i.e., the first row of the Mat
+    // is the last row of the image (e.g., most BMP files).
+    // Tiles passed to the conversion functions are still in image coordinates.
+    bool   flipVertically{false};
+
+    // 3- and 4-channel Mats store RGB(A) instead of BGR(A) (e.g., PPM files).
+    bool   swapRedBlue{false};
+
+    // The fourth channel of CV_8UC4 Mats is not alpha but unused
+    // (e.g., 32-bit BMP files), so the image is opaque.
+    bool   ignoreAlpha{false};
+};
+
+/**
+    Returns the depth of wxBitmap ConvertMatBitmapTowxBitmap()
+    requires for matBitmap: 32 for CV_8UC4 (unless options.ignoreAlpha is true),
+    24 for all other supported types and 0 if the Mat type is not supported.
+*/
+int GetwxBitmapDepthForMatBitmap(const cv::Mat& matBitmap,
+                                 const MatBitmapConversionOptions& options = MatBitmapConversionOptions());
 
 /**
     @param matBitmap
-        Its data must be encoded as BGR CV_8UC3, which is
-        probably the most common format for OpenCV images.
+        Its data must be encoded as one of:
+         - CV_8UC3, CV_16UC3, or CV_32FC3 (BGR),
+         - CV_8UC4 (BGRA),
+         - CV_8UC1, CV_16UC1, or CV_32FC1 (grayscale).
+        The most common format for OpenCV images is BGR CV_8UC3.
     @param bitmap
         It must be initialized to the same width and height as matBitmap
-        and its depth must be 24.
+        and its depth must be the one returned by GetwxBitmapDepthForMatBitmap().
+        CV_8UC4 Mat can also be converted to a 24-bit bitmap, the alpha
+        channel is then ignored.
+    @param options
+        See MatBitmapConversionOptions.
     @return @true if the conversion succeeded, @false otherwise.
 
 
@@ -29,7 +100,8 @@ class wxBitmap;
     the portable one otherwise. In my testing on MSW with
     3840x2160 image in the Release build, the optimized version
     was about 25% faster then the portable one. MSW-optimized version
-    is used when bitmap is a DIB and its width modulo 4 is 0.
+    is used when matBitmap is CV_8UC3 not requiring any value mapping,
+    bitmap is a DIB and its width modulo 4 is 0.
 
     In my testing on MSW with MSVS using 3840x2160 image, the portable
     version of conversion function in the Debug build was more then
@@ -41,7 +113,137 @@ class wxBitmap;
     wxBitmap outside the loop and reusing it in the loop instead
     of creating it every time inside the loop.
 */
-bool ConvertMatBitmapTowxBitmap(const cv::Mat& matBitmap, wxBitmap& bitmap);
+bool ConvertMatBitmapTowxBitmap(const cv::Mat& matBitmap, wxBitmap& bitmap,
+                                const MatBitmapConversionOptions& options = MatBitmapConversionOptions());
+
+/**
+    The same as above but only the given tiles of matBitmap are converted,
+    the rest of bitmap is left intact. Meant to be used with
+    GetChangedMatBitmapTiles() for updating a bitmap which already
+    contains the previous frame of a mostly static video.
+
+    @param tiles
+        Rectangles in matBitmap (and bitmap) coordinates, they must
+        be inside matBitmap. The MSW-optimized version is never used.
+    @param options
+        As the value mapping is computed for the whole matBitmap,
+        normalize should not be used: the mapping could differ from the one
+        used for the tiles which were not updated.
+*/
+bool ConvertMatBitmapTowxBitmap(const cv::Mat& matBitmap, wxBitmap& bitmap,
+                                const std::vector<wxRect>& tiles,
+                                const MatBitmapConversionOptions& options = MatBitmapConversionOptions());
+
+/**
+    @param matBitmap
+        The same requirements as for ConvertMatBitmapTowxBitmap().
+    @param image
+        It must be initialized to the same width and height as matBitmap.
+        Its data are overwritten in place. When matBitmap is CV_8UC4,
+        the alpha channel is copied to the image, which is given
+        the alpha buffer if it did not have one.
+    @param options
+        See MatBitmapConversionOptions.
+    @return @true if the conversion succeeded, @false otherwise.
+
+    Unlike wxBitmap, wxImage does not require a GUI, so this
+    function can be used e.g. in command line tools.
+*/
+bool ConvertMatBitmapTowxImage(const cv::Mat& matBitmap, wxImage& image,
+                               const MatBitmapConversionOptions& options = MatBitmapConversionOptions());
+
+/**
+    @param bitmap
+        It must be valid. Bitmaps with alpha are converted
+        to CV_8UC4 (BGRA), all others to CV_8UC3 (BGR).
+    @param matBitmap
+        Receives the converted data, it is reallocated
+        only if its size or type do not match.
+    @return @true if the conversion succeeded, @false otherwise.
+
+    24-bit bitmaps and bitmaps with alpha are converted directly
+    from their raw data using the same row kernels as
+    ConvertMatBitmapTowxBitmap(), other bitmaps are converted
+    via wxImage.
+*/
+bool ConvertwxBitmapToMatBitmap(const wxBitmap& bitmap, cv::Mat& matBitmap);
+
+/**
+    @param image
+        It must be valid. Images with alpha are converted
+        to CV_8UC4 (BGRA), all others to CV_8UC3 (BGR).
+    @param matBitmap
+        Receives the converted data, it is reallocated
+        only if its size or type do not match.
+    @param shareRGBData
+        If @true and image has no alpha, matBitmap becomes a CV_8UC3
+        Mat header wrapping the image data, i.e., no data are copied.
+        However, the channel order is then RGB instead of BGR and
+        matBitmap is valid only as long as the image data are.
+    @return @true if the conversion succeeded, @false otherwise.
+*/
+bool ConvertwxImageToMatBitmap(const wxImage& image, cv::Mat& matBitmap,
+                               bool shareRGBData = false);
+
+/**
+    Finds out which tiles of matBitmap differ from previousMatBitmap.
+
+    @param matBitmap
+        It must have the same size and type as previousMatBitmap.
+    @param tileSize
+        Width and height of a tile in pixels, the tiles in the last
+        column and row may be smaller.
+    @param threshold
+        A tile is changed when a value in it differs by more than threshold.
+        With 0, the rows are compared with memcmp(), otherwise with cv::norm().
+        A small threshold can be used to ignore the sensor noise.
+    @param tiles
+        Receives the changed tiles, horizontally adjacent tiles
+        are merged into a single rectangle.
+    @return @true if the comparison succeeded, @false otherwise.
+*/
+bool GetChangedMatBitmapTiles(const cv::Mat& matBitmap, const cv::Mat& previousMatBitmap,
+                              int tileSize, double threshold, std::vector<wxRect>& tiles);
+
+#ifdef __WXGTK3__
+
+/**
+    wxGTK3 only.
+
+    @param matBitmap
+        The same requirements as for ConvertMatBitmapTowxBitmap().
+    @param surface
+        It must be a cairo image surface with the same width and height
+        as matBitmap, its format must be CAIRO_FORMAT_RGB24 or
+        CAIRO_FORMAT_ARGB32. The latter should be used for CV_8UC4
+        (the colour values are then premultiplied by alpha as cairo requires),
+        for all other Mat types the alpha is set to 255.
+    @param options
+        See MatBitmapConversionOptions.
+    @return @true if the conversion succeeded, @false otherwise.
+
+    wxGTK3 draws bitmaps with cairo, so a wxBitmap (stored as
+    GdkPixbuf) must be converted to a cairo surface when drawn
+    for the first time after its data were changed. For a video
+    stream this means another full-frame conversion on every paint.
+    Data converted directly into the cairo native 32-bit layout
+    can be drawn with a plain blit instead, see
+    wxBitmapFromOpenCVPanel::SetSurface().
+*/
+bool ConvertMatBitmapToCairoSurface(const cv::Mat& matBitmap, cairo_surface_t* surface,
+                                    const MatBitmapConversionOptions& options = MatBitmapConversionOptions());
+
+/**
+    wxGTK3 only.
+
+    The same as above but only the given tiles are converted,
+    see the tile version of ConvertMatBitmapTowxBitmap().
+*/
+bool ConvertMatBitmapToCairoSurface(const cv::Mat& matBitmap, cairo_surface_t* surface,
+                                    const std::vector<wxRect>& tiles,
+                                    const MatBitmapConversionOptions& options = MatBitmapConversionOptions());
+
+#endif // #ifdef __WXGTK3__
 
 
-#endif // #ifndef CONVERTMATTOWXBMP_H
\ No newline at end of file
+#endif // #ifndef CONVERTMATTOWXBMP_H
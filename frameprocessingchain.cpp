@@ -0,0 +1,232 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        frameprocessingchain.cpp
+// Purpose:     Processes OpenCV frames on a pool of worker threads
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <wx/wx.h>
+
+#include <algorithm>
+
+#include "frameprocessingchain.h"
+
+FrameProcessingChain::FrameProcessingChain(OutputFunction output, size_t workerCount,
+                                           size_t maxFramesInFlight)
+    : m_output(std::move(output)),
+      m_stages(std::make_shared<const Stages>())
+{
+    wxASSERT(m_output);
+
+    if ( workerCount == 0 )
+        workerCount = std::max(1u, std::thread::hardware_concurrency());
+
+    m_maxFramesInFlight = maxFramesInFlight ? maxFramesInFlight : workerCount * 2;
+
+    for ( size_t i = 0; i < workerCount; ++i )
+        m_workers.emplace_back(&FrameProcessingChain::WorkerEntry, this);
+}
+
+FrameProcessingChain::~FrameProcessingChain()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_stopping = true;
+        m_jobs.clear();
+    }
+
+    m_jobAvailable.notify_all();
+    m_frameDelivered.notify_all();
+
+    for ( auto& worker : m_workers )
+        worker.join();
+}
+
+void FrameProcessingChain::SetStages(const std::vector<FrameProcessingStage>& stages)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_stages = std::make_shared<const Stages>(stages);
+
+    m_stageStats.clear();
+    for ( const auto& stage : stages )
+    {
+        StageStats stats;
+
+        stats.name = stage.name;
+        m_stageStats.push_back(stats);
+    }
+}
+
+bool FrameProcessingChain::HasStages() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    return !m_stages->empty();
+}
+
+bool FrameProcessingChain::Submit(const cv::Mat& matBitmap, long timeGet, bool waitIfFull)
+{
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+
+        if ( waitIfFull )
+        {
+            m_frameDelivered.wait(lock,
+                [this] { return m_stopping || m_framesInFlight < m_maxFramesInFlight; });
+        }
+
+        if ( m_stopping )
+            return false;
+
+        if ( m_framesInFlight >= m_maxFramesInFlight )
+        {
+            m_framesDropped++;
+            return false;
+        }
+
+        Job job;
+
+        job.frame.matBitmap = matBitmap;
+        job.frame.sequenceNumber = m_nextSequenceNumber++;
+        job.frame.timeGet = timeGet;
+        job.stages = m_stages;
+
+        m_jobs.push_back(std::move(job));
+        m_framesInFlight++;
+    }
+
+    m_jobAvailable.notify_one();
+    return true;
+}
+
+void FrameProcessingChain::WaitUntilDelivered()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    m_frameDelivered.wait(lock, [this] { return m_stopping || m_framesInFlight == 0; });
+}
+
+FrameProcessingChain::Stats FrameProcessingChain::GetStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats                       stats;
+
+    stats.stages = m_stageStats;
+    stats.workerCount = m_workers.size();
+    stats.framesInFlight = m_framesInFlight;
+    stats.framesProcessed = m_framesProcessed;
+    stats.framesDropped = m_framesDropped;
+
+    return stats;
+}
+
+void FrameProcessingChain::WorkerEntry()
+{
+    for ( ;; )
+    {
+        Job job;
+
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+
+            m_jobAvailable.wait(lock, [this] { return m_stopping || !m_jobs.empty(); });
+
+            if ( m_stopping )
+                return;
+
+            job = std::move(m_jobs.front());
+            m_jobs.pop_front();
+        }
+
+        ProcessJob(job);
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_framesProcessed++;
+
+            // the stats are for the current stages only
+            if ( job.stages == m_stages )
+            {
+                for ( size_t i = 0; i < job.frame.stageTimes.size(); ++i )
+                {
+                    m_stageStats[i].lastTime = job.frame.stageTimes[i];
+                    m_stageStats[i].totalTime += job.frame.stageTimes[i];
+                    m_stageStats[i].count++;
+                }
+            }
+
+            m_completedFrames[job.frame.sequenceNumber] = std::move(job.frame);
+        }
+
+        DeliverCompletedFrames();
+    }
+}
+
+void FrameProcessingChain::ProcessJob(Job& job)
+{
+    Frame& frame = job.frame;
+
+    for ( const auto& stage : *job.stages )
+    {
+        const int64 startTicks = cv::getTickCount();
+
+        try
+        {
+            frame.matBitmap = stage.process(frame.matBitmap);
+        }
+        catch ( const std::exception& e )
+        {
+            frame.errorMessage = wxString::Format("Stage '%s' failed: %s", stage.name, e.what());
+            return;
+        }
+        catch ( ... )
+        {
+            frame.errorMessage = wxString::Format("Stage '%s' failed: Unknown exception", stage.name);
+            return;
+        }
+
+        frame.stageTimes.push_back((cv::getTickCount() - startTicks) * 1000. / cv::getTickFrequency());
+    }
+}
+
+void FrameProcessingChain::DeliverCompletedFrames()
+{
+    // Another worker may complete the next frame to deliver while
+    // this one is delivering, it then delivers it after this one is done.
+    std::lock_guard<std::mutex> deliveryLock(m_deliveryMutex);
+
+    for ( ;; )
+    {
+        Frame frame;
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            const auto it = m_completedFrames.find(m_nextSequenceNumberToDeliver);
+
+            if ( m_stopping || it == m_completedFrames.end() )
+                return;
+
+            frame = std::move(it->second);
+            m_completedFrames.erase(it);
+            m_nextSequenceNumberToDeliver++;
+        }
+
+        m_output(frame);
+
+        // Only now, so that WaitUntilDelivered() does not
+        // return before the output function has returned.
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            m_framesInFlight--;
+        }
+
+        m_frameDelivered.notify_all();
+    }
+}
@@ -0,0 +1,150 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        frameprocessingchain.h
+// Purpose:     Processes OpenCV frames on a pool of worker threads
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef FRAMEPROCESSINGCHAIN_H
+#define FRAMEPROCESSINGCHAIN_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <wx/string.h>
+
+#include <opencv2/core.hpp>
+
+/**
+    A single step of FrameProcessingChain, e.g., denoising
+    or edge detection, taking a frame and returning the processed one.
+
+    process may be called from several threads at once (for different
+    frames), so it must not modify any shared state. It must not modify
+    its input either, the input can be the Mat captured from a camera.
+*/
+struct FrameProcessingStage
+{
+    wxString                               name;
+    std::function<cv::Mat(const cv::Mat&)> process;
+};
+
+/**
+    Runs frames through a sequence of stages on a pool of worker threads.
+
+    Each frame is processed by all stages in one worker, several frames
+    are processed at once by different workers. The processed frames
+    are nevertheless passed to the output function in the order
+    they were submitted.
+
+    When the processing is slower than the frames are submitted,
+    the frames exceeding the maximum number of frames in flight
+    are dropped in Submit().
+*/
+class FrameProcessingChain
+{
+public:
+    struct Frame
+    {
+        cv::Mat             matBitmap;
+        unsigned long       sequenceNumber{0};
+        long                timeGet{0};   // passed through unchanged
+        std::vector<double> stageTimes;   // in ms, for each stage run
+        // When a stage throws, the remaining stages are skipped
+        // and matBitmap is the input of the stage which threw.
+        wxString            errorMessage;
+    };
+
+    struct StageStats
+    {
+        wxString      name;
+        double        lastTime{0.0};  // ms
+        double        totalTime{0.0}; // ms
+        unsigned long count{0};
+
+        double GetMeanTime() const { return count ? totalTime / count : 0.0; }
+    };
+
+    struct Stats
+    {
+        std::vector<StageStats> stages; // since SetStages() was last called
+        size_t        workerCount{0};
+        size_t        framesInFlight{0};
+        unsigned long framesProcessed{0};
+        unsigned long framesDropped{0};
+    };
+
+    // Called from the worker threads, never for two frames at once,
+    // in the order the frames were submitted.
+    typedef std::function<void(Frame& frame)> OutputFunction;
+
+    // When workerCount is 0, the number of hardware threads is used.
+    // When maxFramesInFlight is 0, twice the number of workers is used.
+    FrameProcessingChain(OutputFunction output, size_t workerCount = 0, size_t maxFramesInFlight = 0);
+    // Waits for the workers to finish the frames they are processing,
+    // the frames not yet delivered are discarded.
+    ~FrameProcessingChain();
+
+    // Can be called at any time, the frames already submitted
+    // are processed by the stages set at the time of their submission.
+    void SetStages(const std::vector<FrameProcessingStage>& stages);
+    bool HasStages() const;
+
+    size_t GetMaxFramesInFlight() const { return m_maxFramesInFlight; }
+
+    // Returns false if the frame was dropped because there
+    // were too many frames in flight. The frame data are not copied.
+    // When waitIfFull is true, the frame is never dropped, the call
+    // instead blocks until there is room for it.
+    bool Submit(const cv::Mat& matBitmap, long timeGet, bool waitIfFull = false);
+
+    // Blocks until all the submitted frames are passed to the output function.
+    void WaitUntilDelivered();
+
+    Stats GetStats() const;
+
+private:
+    typedef std::vector<FrameProcessingStage> Stages;
+
+    struct Job
+    {
+        Frame                         frame;
+        std::shared_ptr<const Stages> stages;
+    };
+
+    OutputFunction                m_output;
+    size_t                        m_maxFramesInFlight{0};
+    std::vector<std::thread>      m_workers;
+
+    // guards all the members below
+    mutable std::mutex            m_mutex;
+    std::condition_variable       m_jobAvailable;
+    std::condition_variable       m_frameDelivered;
+    bool                          m_stopping{false};
+    std::shared_ptr<const Stages> m_stages;
+    std::vector<StageStats>       m_stageStats;
+    std::deque<Job>               m_jobs;
+    std::map<unsigned long, Frame> m_completedFrames;
+    unsigned long                 m_nextSequenceNumber{0};
+    unsigned long                 m_nextSequenceNumberToDeliver{0};
+    size_t                        m_framesInFlight{0};
+    unsigned long                 m_framesProcessed{0};
+    unsigned long                 m_framesDropped{0};
+
+    // serializes calls to m_output
+    std::mutex                    m_deliveryMutex;
+
+    void WorkerEntry();
+    void ProcessJob(Job& job);
+    void DeliverCompletedFrames();
+};
+
+#endif // #ifndef FRAMEPROCESSINGCHAIN_H
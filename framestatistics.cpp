@@ -0,0 +1,271 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        framestatistics.cpp
+// Purpose:     Computes histograms and exposure statistics of camera frames
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cmath>
+#include <cstring>
+
+#include "framestatistics.h"
+
+namespace {
+
+// Number of histograms each channel is accumulated in. A histogram update
+// is a load and a store of the same counter, so when consecutive samples have
+// the same value, the next update must wait for the previous one. With several
+// banks, consecutive samples go to different banks and can be counted in parallel.
+// Unlike a per-pixel conversion, the updates themselves cannot be vectorized.
+const int HistogramBanks = 4;
+
+typedef uint32_t BankHistograms[HistogramBanks][FrameStatistics::MaxChannels][FrameStatistics::BinCount];
+
+// Accumulates every step-th pixel of a row with count pixels,
+// SrcChannels is the number of channels in the row, the first
+// Channels of them are accumulated.
+template <int Channels, int SrcChannels>
+void AccumulateRow(const uchar* row, int count, int step, BankHistograms& histograms)
+{
+    const size_t stride = static_cast<size_t>(SrcChannels) * step;
+    const uchar* p = row;
+    int          i = 0;
+
+    for ( ; i + HistogramBanks <= count; i += HistogramBanks, p += HistogramBanks * stride )
+    {
+        for ( int c = 0; c < Channels; ++c )
+        {
+            ++histograms[0][c][p[c]];
+            ++histograms[1][c][p[stride + c]];
+            ++histograms[2][c][p[2 * stride + c]];
+            ++histograms[3][c][p[3 * stride + c]];
+        }
+    }
+
+    for ( ; i < count; ++i, p += stride )
+    {
+        for ( int c = 0; c < Channels; ++c )
+            ++histograms[0][c][p[c]];
+    }
+}
+
+template <int Channels, int SrcChannels>
+void AccumulateMat(const cv::Mat& matBitmap, int gridStep, BankHistograms& histograms)
+{
+    const int count = (matBitmap.cols + gridStep - 1) / gridStep;
+
+    for ( int row = 0; row < matBitmap.rows; row += gridStep )
+        AccumulateRow<Channels, SrcChannels>(matBitmap.ptr<uchar>(row), count, gridStep, histograms);
+}
+
+} // unnamed namespace
+
+//
+// FrameStatistics
+//
+
+void FrameStatistics::Clear()
+{
+    channels = 0;
+    sampleCount = 0;
+    frameCount = 0;
+    memset(histograms, 0, sizeof(histograms));
+}
+
+void FrameStatistics::Add(const FrameStatistics& other)
+{
+    if ( other.IsEmpty() )
+        return;
+
+    if ( channels != other.channels )
+    {
+        *this = other;
+        return;
+    }
+
+    for ( int c = 0; c < channels; ++c )
+    {
+        for ( int v = 0; v < BinCount; ++v )
+            histograms[c][v] += other.histograms[c][v];
+    }
+
+    sampleCount += other.sampleCount;
+    frameCount += other.frameCount;
+}
+
+double FrameStatistics::GetMean(int channel) const
+{
+    wxCHECK(channel >= 0 && channel < channels, 0.);
+
+    if ( sampleCount == 0 )
+        return 0.;
+
+    double sum = 0.;
+
+    for ( int v = 0; v < BinCount; ++v )
+        sum += static_cast<double>(v) * histograms[channel][v];
+
+    return sum / sampleCount;
+}
+
+double FrameStatistics::GetVariance(int channel) const
+{
+    wxCHECK(channel >= 0 && channel < channels, 0.);
+
+    if ( sampleCount == 0 )
+        return 0.;
+
+    const double mean = GetMean(channel);
+    double       sum = 0.;
+
+    for ( int v = 0; v < BinCount; ++v )
+        sum += (v - mean) * (v - mean) * histograms[channel][v];
+
+    return sum / sampleCount;
+}
+
+double FrameStatistics::GetStdDev(int channel) const
+{
+    return std::sqrt(GetVariance(channel));
+}
+
+double FrameStatistics::GetUnderexposedFraction(int channel) const
+{
+    wxCHECK(channel >= 0 && channel < channels, 0.);
+
+    return sampleCount ? static_cast<double>(histograms[channel][0]) / sampleCount : 0.;
+}
+
+double FrameStatistics::GetOverexposedFraction(int channel) const
+{
+    wxCHECK(channel >= 0 && channel < channels, 0.);
+
+    return sampleCount ? static_cast<double>(histograms[channel][BinCount - 1]) / sampleCount : 0.;
+}
+
+bool ComputeFrameStatistics(const cv::Mat& matBitmap, int gridStep, FrameStatistics& statistics)
+{
+    wxCHECK(gridStep >= 1, false);
+
+    statistics.Clear();
+
+    const int type = matBitmap.type();
+
+    if ( matBitmap.empty() || (type != CV_8UC1 && type != CV_8UC3 && type != CV_8UC4) )
+        return false;
+
+    // 12 KB (4 banks x 3 channels x 256 bins x 4 bytes), cheaper to clear than to allocate
+    BankHistograms histograms;
+
+    memset(histograms, 0, sizeof(histograms));
+
+    if ( type == CV_8UC1 )
+        AccumulateMat<1, 1>(matBitmap, gridStep, histograms);
+    else if ( type == CV_8UC3 )
+        AccumulateMat<3, 3>(matBitmap, gridStep, histograms);
+    else
+        AccumulateMat<3, 4>(matBitmap, gridStep, histograms);
+
+    statistics.channels = type == CV_8UC1 ? 1 : 3;
+    statistics.sampleCount = static_cast<uint64_t>((matBitmap.cols + gridStep - 1) / gridStep)
+                             * ((matBitmap.rows + gridStep - 1) / gridStep);
+    statistics.frameCount = 1;
+
+    for ( int c = 0; c < statistics.channels; ++c )
+    {
+        for ( int v = 0; v < FrameStatistics::BinCount; ++v )
+        {
+            statistics.histograms[c][v] = static_cast<uint64_t>(histograms[0][c][v]) + histograms[1][c][v]
+                                          + histograms[2][c][v] + histograms[3][c][v];
+        }
+    }
+
+    return true;
+}
+
+wxString FormatFrameStatistics(const FrameStatistics& statistics)
+{
+    static const char* const channelNames[] = { "B", "G", "R" };
+
+    wxString text;
+
+    for ( int c = 0; c < statistics.channels; ++c )
+    {
+        text += wxString::Format("%s: mean %.1f, std. dev. %.1f, clipped %.2f %% black, %.2f %% white\n",
+            statistics.channels == 1 ? "Gray" : channelNames[c],
+            statistics.GetMean(c), statistics.GetStdDev(c),
+            statistics.GetUnderexposedFraction(c) * 100., statistics.GetOverexposedFraction(c) * 100.);
+    }
+
+    return text;
+}
+
+//
+// FrameStatisticsCollector
+//
+
+FrameStatisticsCollector::FrameStatisticsCollector(int gridStep, long publishIntervalMs)
+    : m_gridStep(gridStep),
+      m_publishInterval(std::chrono::milliseconds(publishIntervalMs))
+{
+    wxASSERT(m_gridStep >= 1);
+}
+
+void FrameStatisticsCollector::AddFrame(const cv::Mat& matBitmap)
+{
+    FrameStatistics frameStatistics;
+
+    if ( !ComputeFrameStatistics(matBitmap, m_gridStep, frameStatistics) )
+        return;
+
+    const Clock::time_point     now = Clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if ( m_accumulated.IsEmpty() )
+        m_accumulateStart = now;
+
+    m_accumulated.Add(frameStatistics);
+
+    if ( now - m_accumulateStart >= m_publishInterval )
+    {
+        m_published = m_accumulated;
+        m_accumulated.Clear();
+        m_publishCount++;
+    }
+}
+
+bool FrameStatisticsCollector::GetPublished(FrameStatistics& statistics, unsigned long& publishCount) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if ( publishCount == m_publishCount )
+        return false;
+
+    statistics = m_published;
+    publishCount = m_publishCount;
+    return true;
+}
+
+void FrameStatisticsCollector::Reset()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_accumulated.Clear();
+    m_published.Clear();
+    // so that those who got the discarded statistics get the empty ones
+    m_publishCount++;
+}
+
+FrameProcessingStage CreateFrameStatisticsStage(std::shared_ptr<FrameStatisticsCollector> collector)
+{
+    wxASSERT(collector);
+
+    return { "Statistics", [collector](const cv::Mat& in)
+        {
+            collector->AddFrame(in);
+            return in;
+        }
+    };
+}
@@ -0,0 +1,119 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        framestatistics.h
+// Purpose:     Computes histograms and exposure statistics of camera frames
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef FRAMESTATISTICS_H
+#define FRAMESTATISTICS_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+
+#include <wx/string.h>
+
+#include <opencv2/core.hpp>
+
+#include "frameprocessingchain.h"
+
+/**
+    Per-channel histograms of 8-bit frames and the exposure statistics
+    derived from them, i.e., mean, variance, and the fractions
+    of clipped (black or saturated) samples.
+
+    The statistics can be accumulated over several frames, the mean
+    and variance are then of all the samples in those frames.
+*/
+struct FrameStatistics
+{
+    enum
+    {
+        BinCount    = 256,
+        MaxChannels = 3,
+    };
+
+    // 1 for grayscale, 3 for BGR (alpha is ignored), 0 when empty
+    int           channels{0};
+    // samples per channel, in all frames
+    uint64_t      sampleCount{0};
+    unsigned long frameCount{0};
+    // histograms[c][v] is the number of samples of channel c with value v
+    uint64_t      histograms[MaxChannels][BinCount];
+
+    FrameStatistics() { Clear(); }
+
+    void Clear();
+    bool IsEmpty() const { return channels == 0; }
+
+    // Adds the statistics of other frames. When these statistics
+    // are of a different number of channels, they are replaced.
+    void Add(const FrameStatistics& other);
+
+    double GetMean(int channel) const;
+    double GetVariance(int channel) const;
+    double GetStdDev(int channel) const;
+
+    // fractions (0.0 - 1.0) of the samples with value 0 and 255, respectively
+    double GetUnderexposedFraction(int channel) const;
+    double GetOverexposedFraction(int channel) const;
+};
+
+// Computes the statistics of a CV_8UC1, CV_8UC3, or CV_8UC4 matBitmap (other types
+// are not supported) from the pixels in every gridStep-th column of every gridStep-th row.
+// The histograms are accumulated in several banks, so that consecutive samples
+// with the same value (common in flat areas) do not stall on incrementing the same counter.
+bool ComputeFrameStatistics(const cv::Mat& matBitmap, int gridStep, FrameStatistics& statistics);
+
+// Returns the statistics as lines of text, one per channel.
+wxString FormatFrameStatistics(const FrameStatistics& statistics);
+
+/**
+    Accumulates the statistics of frames added from any number
+    of threads and publishes them at a lower rate than the frames
+    arrive (e.g., a few times per second, for display).
+
+    The statistics of a frame are computed without holding a lock,
+    it is held only to add them to those already accumulated.
+*/
+class FrameStatisticsCollector
+{
+public:
+    // See ComputeFrameStatistics() for gridStep.
+    FrameStatisticsCollector(int gridStep = 4, long publishIntervalMs = 250);
+
+    void AddFrame(const cv::Mat& matBitmap);
+
+    // When statistics other than those identified by publishCount were published,
+    // copies them to statistics, updates publishCount, and returns true.
+    // publishCount should be initially 0.
+    bool GetPublished(FrameStatistics& statistics, unsigned long& publishCount) const;
+
+    // Discards both the accumulated and published statistics.
+    void Reset();
+
+    int GetGridStep() const { return m_gridStep; }
+
+private:
+    typedef std::chrono::steady_clock Clock;
+
+    const int             m_gridStep;
+    const Clock::duration m_publishInterval;
+
+    // guards all the members below
+    mutable std::mutex    m_mutex;
+    FrameStatistics       m_accumulated;
+    Clock::time_point     m_accumulateStart;
+    FrameStatistics       m_published;
+    unsigned long         m_publishCount{0};
+};
+
+// Returns a processing stage adding each frame to collector
+// and passing it through unchanged, i.e., without copying it.
+FrameProcessingStage CreateFrameStatisticsStage(std::shared_ptr<FrameStatisticsCollector> collector);
+
+#endif // #ifndef FRAMESTATISTICS_H
@@ -0,0 +1,468 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        mappedimage.cpp
+// Purpose:     Loads uncompressed image files memory-mapped
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <wx/wx.h>
+#include <wx/filename.h>
+#include <wx/tokenzr.h>
+
+#include <cctype>
+#include <climits>
+#include <cstdint>
+
+#ifdef __WINDOWS__
+    #include <wx/msw/wrapwin.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "mappedimage.h"
+
+namespace
+{
+
+// BMP and DIB header values
+const size_t   BMPFileHeaderSize   = 14;
+const size_t   BMPInfoHeaderSize   = 40;
+const wxUint32 BMPCompressionRGB       = 0; // BI_RGB
+const wxUint32 BMPCompressionBitFields = 3; // BI_BITFIELDS
+
+wxUint16 ReadUint16LE(const uchar* data)
+{
+    return static_cast<wxUint16>(data[0] | (data[1] << 8));
+}
+
+wxUint32 ReadUint32LE(const uchar* data)
+{
+    return static_cast<wxUint32>(data[0]) | (static_cast<wxUint32>(data[1]) << 8)
+           | (static_cast<wxUint32>(data[2]) << 16) | (static_cast<wxUint32>(data[3]) << 24);
+}
+
+// Reads a positive decimal number from a PNM header, skipping
+// the whitespace and comments before it. Returns -1 on error.
+long ReadPNMNumber(const uchar* data, size_t size, size_t& position)
+{
+    while ( position < size )
+    {
+        if ( data[position] == '#' )
+        {
+            while ( position < size && data[position] != '\n' && data[position] != '\r' )
+                ++position;
+        }
+        else if ( isspace(data[position]) )
+        {
+            ++position;
+        }
+        else
+        {
+            break;
+        }
+    }
+
+    long long value = -1;
+
+    while ( position < size && isdigit(data[position]) )
+    {
+        value = (value < 0 ? 0 : value * 10) + (data[position++] - '0');
+        if ( value > INT_MAX )
+            return -1;
+    }
+
+    return static_cast<long>(value);
+}
+
+} // unnamed namespace
+
+//
+// RawImageLayout
+//
+
+bool RawImageLayout::Parse(const wxString& description)
+{
+    static const struct
+    {
+        const char* name;
+        int         type;
+    } types[] =
+    {
+        { "8UC1",  CV_8UC1 },
+        { "8UC3",  CV_8UC3 },
+        { "8UC4",  CV_8UC4 },
+        { "16UC1", CV_16UC1 },
+        { "16UC3", CV_16UC3 },
+        { "32FC1", CV_32FC1 },
+        { "32FC3", CV_32FC3 },
+    };
+
+    const wxArrayString parts = wxStringTokenize(description, " \t");
+    wxString            heightStr;
+    long                w = 0, h = 0;
+    unsigned long       stride = 0, offs = 0;
+
+    if ( parts.size() < 2 || parts.size() > 4 )
+        return false;
+
+    if ( !parts[0].BeforeFirst('x', &heightStr).ToLong(&w) || !heightStr.ToLong(&h)
+         || w <= 0 || h <= 0 || w > INT_MAX || h > INT_MAX )
+    {
+        return false;
+    }
+
+    if ( parts.size() > 2 && !parts[2].ToULong(&stride) )
+        return false;
+    if ( parts.size() > 3 && !parts[3].ToULong(&offs) )
+        return false;
+
+    for ( const auto& t : types )
+    {
+        if ( parts[1].CmpNoCase(t.name) == 0 )
+        {
+            width = static_cast<int>(w);
+            height = static_cast<int>(h);
+            type = t.type;
+            rowStride = stride;
+            offset = offs;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//
+// MappedImage
+//
+
+MappedImage::~MappedImage()
+{
+    Close();
+}
+
+bool MappedImage::Open(const wxString& fileName, wxString& errorMessage)
+{
+    Close();
+
+    if ( !Map(fileName, errorMessage) )
+        return false;
+
+    bool wrapped = false;
+
+    if ( m_size >= 2 && m_data[0] == 'B' && m_data[1] == 'M' )
+        wrapped = WrapBMP(errorMessage);
+    else if ( m_size >= 2 && m_data[0] == 'P' && (m_data[1] == '5' || m_data[1] == '6') )
+        wrapped = WrapPNM(errorMessage);
+    else
+        errorMessage = "Not a BMP, binary PGM, or binary PPM file.";
+
+    if ( !wrapped )
+        Close();
+
+    return wrapped;
+}
+
+bool MappedImage::OpenRaw(const wxString& fileName, const RawImageLayout& layout, wxString& errorMessage)
+{
+    Close();
+
+    if ( !Map(fileName, errorMessage) )
+        return false;
+
+    if ( !WrapPixels(layout.width, layout.height, layout.type, layout.rowStride, layout.offset, errorMessage) )
+    {
+        Close();
+        return false;
+    }
+
+    return true;
+}
+
+void MappedImage::Close()
+{
+    m_matBitmap.release();
+    m_conversionOptions = MatBitmapConversionOptions();
+
+    if ( !m_data )
+        return;
+
+#ifdef __WINDOWS__
+    ::UnmapViewOfFile(m_data);
+#else
+    munmap(const_cast<uchar*>(m_data), m_size);
+#endif
+
+    m_data = nullptr;
+    m_size = 0;
+}
+
+bool MappedImage::IsSupportedFileName(const wxString& fileName)
+{
+    const wxString ext = wxFileName(fileName).GetExt().Lower();
+
+    return ext == "bmp" || ext == "dib" || ext == "pgm" || ext == "ppm" || ext == "pnm";
+}
+
+bool MappedImage::Map(const wxString& fileName, wxString& errorMessage)
+{
+    wxCHECK(!m_data, false);
+
+    // The file is mapped read-only and the handles can be closed right away,
+    // the mapping keeps the file open.
+#ifdef __WINDOWS__
+    const HANDLE file = ::CreateFileW(fileName.wc_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                      OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    LARGE_INTEGER fileSize{0};
+
+    if ( file == INVALID_HANDLE_VALUE || !::GetFileSizeEx(file, &fileSize) )
+    {
+        errorMessage.Printf("Could not open '%s'.", fileName);
+        if ( file != INVALID_HANDLE_VALUE )
+            ::CloseHandle(file);
+        return false;
+    }
+
+    if ( fileSize.QuadPart == 0 || static_cast<ULONGLONG>(fileSize.QuadPart) > SIZE_MAX )
+    {
+        errorMessage.Printf("'%s' is empty or too large to map.", fileName);
+        ::CloseHandle(file);
+        return false;
+    }
+
+    const HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+
+    ::CloseHandle(file);
+
+    if ( !mapping )
+    {
+        errorMessage.Printf("Could not map '%s'.", fileName);
+        return false;
+    }
+
+    m_data = static_cast<const uchar*>(::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    ::CloseHandle(mapping);
+
+    if ( !m_data )
+    {
+        errorMessage.Printf("Could not map '%s'.", fileName);
+        return false;
+    }
+
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+#else
+    const int   file = open(fileName.fn_str(), O_RDONLY);
+    struct stat fileStat;
+
+    if ( file == -1 || fstat(file, &fileStat) != 0 )
+    {
+        errorMessage.Printf("Could not open '%s'.", fileName);
+        if ( file != -1 )
+            close(file);
+        return false;
+    }
+
+    if ( fileStat.st_size == 0 || static_cast<unsigned long long>(fileStat.st_size) > SIZE_MAX )
+    {
+        errorMessage.Printf("'%s' is empty or too large to map.", fileName);
+        close(file);
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_SHARED, file, 0);
+
+    close(file);
+
+    if ( data == MAP_FAILED )
+    {
+        errorMessage.Printf("Could not map '%s'.", fileName);
+        return false;
+    }
+
+    // the conversion reads the rows in order
+    madvise(data, static_cast<size_t>(fileStat.st_size), MADV_SEQUENTIAL);
+
+    m_data = static_cast<const uchar*>(data);
+    m_size = static_cast<size_t>(fileStat.st_size);
+#endif
+
+    return true;
+}
+
+bool MappedImage::WrapBMP(wxString& errorMessage)
+{
+    if ( m_size < BMPFileHeaderSize + BMPInfoHeaderSize )
+    {
+        errorMessage = "The BMP file is truncated.";
+        return false;
+    }
+
+    const uchar*   infoHeader = m_data + BMPFileHeaderSize;
+    const wxUint32 pixelsOffset = ReadUint32LE(m_data + 10);
+    const wxUint32 infoHeaderSize = ReadUint32LE(infoHeader);
+    const wxInt32  width = static_cast<wxInt32>(ReadUint32LE(infoHeader + 4));
+    const wxInt32  height = static_cast<wxInt32>(ReadUint32LE(infoHeader + 8));
+    const wxUint16 bitCount = ReadUint16LE(infoHeader + 14);
+    const wxUint32 compression = ReadUint32LE(infoHeader + 16);
+
+    // BITMAPCOREHEADER (OS/2) has 16-bit dimensions and is not supported
+    if ( infoHeaderSize < BMPInfoHeaderSize || m_size < BMPFileHeaderSize + infoHeaderSize )
+    {
+        errorMessage = "Unsupported BMP header.";
+        return false;
+    }
+
+    // height == INT_MIN cannot be negated
+    if ( width <= 0 || height == 0 || height == INT_MIN )
+    {
+        errorMessage = "Invalid BMP size.";
+        return false;
+    }
+
+    int type = -1;
+
+    if ( bitCount == 24 && compression == BMPCompressionRGB )
+    {
+        type = CV_8UC3;
+    }
+    else if ( bitCount == 32 && compression == BMPCompressionRGB )
+    {
+        // the fourth byte is unused
+        type = CV_8UC4;
+        m_conversionOptions.ignoreAlpha = true;
+    }
+    else if ( bitCount == 32 && compression == BMPCompressionBitFields )
+    {
+        // The masks follow BITMAPINFOHEADER or are a part of the larger headers,
+        // only the layout OpenCV uses (BGRA) is supported.
+        const uchar* masks = infoHeader + BMPInfoHeaderSize;
+        const bool   hasAlphaMask = infoHeaderSize >= BMPInfoHeaderSize + 16;
+
+        if ( m_size < BMPFileHeaderSize + BMPInfoHeaderSize + 12
+             || ReadUint32LE(masks) != 0x00FF0000
+             || ReadUint32LE(masks + 4) != 0x0000FF00
+             || ReadUint32LE(masks + 8) != 0x000000FF )
+        {
+            errorMessage = "Unsupported BMP colour masks.";
+            return false;
+        }
+
+        type = CV_8UC4;
+        m_conversionOptions.ignoreAlpha = !hasAlphaMask || ReadUint32LE(masks + 12) != 0xFF000000;
+    }
+    else if ( bitCount == 8 && compression == BMPCompressionRGB )
+    {
+        // Only grayscale images, i.e., with the palette mapping
+        // each index to the gray of the same value, can be wrapped.
+        const wxUint32 colorsUsed = ReadUint32LE(infoHeader + 32);
+        const uchar*   palette = infoHeader + infoHeaderSize;
+
+        if ( (colorsUsed != 0 && colorsUsed != 256)
+             || m_size < BMPFileHeaderSize + infoHeaderSize + 256 * 4 )
+        {
+            errorMessage = "Only grayscale 8-bit BMP files are supported.";
+            return false;
+        }
+
+        for ( int i = 0; i < 256; ++i, palette += 4 )
+        {
+            if ( palette[0] != i || palette[1] != i || palette[2] != i )
+            {
+                errorMessage = "Only grayscale 8-bit BMP files are supported.";
+                return false;
+            }
+        }
+
+        type = CV_8UC1;
+    }
+    else
+    {
+        errorMessage.Printf("Unsupported BMP format (%u bits per pixel, compression %u).",
+                            static_cast<unsigned>(bitCount), static_cast<unsigned>(compression));
+        return false;
+    }
+
+    // the rows are padded to 4 bytes
+    const size_t rowStride = (static_cast<size_t>(width) * CV_ELEM_SIZE(type) + 3) & ~static_cast<size_t>(3);
+
+    // positive height means the rows are stored bottom-up
+    m_conversionOptions.flipVertically = height > 0;
+
+    return WrapPixels(width, height > 0 ? height : -height, type, rowStride, pixelsOffset, errorMessage);
+}
+
+bool MappedImage::WrapPNM(wxString& errorMessage)
+{
+    const bool isPPM = m_data[1] == '6';
+    size_t     position = 2;
+    const long width = ReadPNMNumber(m_data, m_size, position);
+    const long height = ReadPNMNumber(m_data, m_size, position);
+    const long maxValue = ReadPNMNumber(m_data, m_size, position);
+
+    // a single whitespace character separates the header from the pixels
+    if ( width <= 0 || height <= 0 || maxValue <= 0 || maxValue > 65535
+         || position >= m_size || !isspace(m_data[position]) )
+    {
+        errorMessage = "Invalid PGM or PPM header.";
+        return false;
+    }
+
+    // 16-bit values are big-endian, they cannot be used without swapping the bytes
+    if ( maxValue > 255 )
+    {
+        errorMessage = "Only PGM and PPM files with 8-bit values are supported.";
+        return false;
+    }
+
+    const int type = isPPM ? CV_8UC3 : CV_8UC1;
+
+    m_conversionOptions.swapRedBlue = isPPM;
+    if ( maxValue != 255 )
+        m_conversionOptions.scale = 255. / maxValue;
+
+    return WrapPixels(static_cast<int>(width), static_cast<int>(height), type,
+                      static_cast<size_t>(width) * CV_ELEM_SIZE(type), position + 1, errorMessage);
+}
+
+bool MappedImage::WrapPixels(int width, int height, int type, size_t rowStride, size_t offset,
+                             wxString& errorMessage)
+{
+    wxCHECK(m_data, false);
+
+    const size_t rowSize = static_cast<size_t>(width) * CV_ELEM_SIZE(type);
+
+    if ( width <= 0 || height <= 0 || type < 0 )
+    {
+        errorMessage = "Invalid image size or type.";
+        return false;
+    }
+
+    if ( rowStride == 0 )
+        rowStride = rowSize;
+
+    // Mat requires the row stride to be a multiple of the element size
+    if ( rowStride < rowSize || rowStride % CV_ELEM_SIZE1(type) != 0 )
+    {
+        errorMessage.Printf("Invalid row stride %lu.", static_cast<unsigned long>(rowStride));
+        return false;
+    }
+
+    // the last row does not need to be padded
+    if ( offset > m_size
+         || m_size - offset < rowSize
+         || (m_size - offset - rowSize) / rowStride < static_cast<size_t>(height - 1) )
+    {
+        errorMessage = "The file is smaller than the image it should contain.";
+        return false;
+    }
+
+    // Mat does not modify the data, it just has no const constructor
+    m_matBitmap = cv::Mat(height, width, type, const_cast<uchar*>(m_data + offset), rowStride);
+
+    return true;
+}
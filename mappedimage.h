@@ -0,0 +1,88 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        mappedimage.h
+// Purpose:     Loads uncompressed image files memory-mapped
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef MAPPEDIMAGE_H
+#define MAPPEDIMAGE_H
+
+#include <wx/string.h>
+
+#include <opencv2/core.hpp>
+
+#include "convertmattowxbmp.h"
+
+// Describes the pixels of a raw image file, which has no header.
+struct RawImageLayout
+{
+    int    width{0};
+    int    height{0};
+    int    type{-1};      // e.g., CV_8UC3
+    size_t rowStride{0};  // in bytes, 0 means the rows are not padded
+    size_t offset{0};     // of the first pixel from the start of the file, in bytes
+
+    // Parses a description in the form "<width>x<height> <type>[ <row stride>[ <offset>]]",
+    // e.g., "1920x1080 8UC3", type being one of 8UC1, 8UC3, 8UC4, 16UC1, 16UC3, 32FC1, or 32FC3.
+    bool Parse(const wxString& description);
+};
+
+/**
+    Maps an uncompressed image file into memory and wraps its pixels
+    in a cv::Mat header, without reading or copying them.
+    The pixels are then read by the conversion straight from the mapped
+    file (i.e., usually from the operating system's file cache).
+
+    Supported are BMP files (uncompressed 8-bit grayscale, 24-bit, and 32-bit),
+    binary PGM and PPM files with 8-bit values, and raw files (see RawImageLayout).
+    These formats may store the pixels differently from what OpenCV expects,
+    e.g., rows bottom-up or RGB instead of BGR, GetConversionOptions()
+    then returns the options needed to convert the Mat correctly.
+
+    Unlike cv::imread(), this class supports Unicode paths.
+*/
+class MappedImage
+{
+public:
+    MappedImage() {}
+    // Unmaps the file, the Mat returned by GetMat() must not be used after that.
+    ~MappedImage();
+
+    // Returns false if the file cannot be mapped or its format is not supported,
+    // errorMessage then contains the reason.
+    bool Open(const wxString& fileName, wxString& errorMessage);
+    bool OpenRaw(const wxString& fileName, const RawImageLayout& layout, wxString& errorMessage);
+
+    void Close();
+
+    bool IsOpened() const { return !m_matBitmap.empty(); }
+
+    // The returned Mat references the mapped data, it may be bottom-up,
+    // RGB, etc. (see GetConversionOptions()) and must not be modified.
+    const cv::Mat& GetMat() const { return m_matBitmap; }
+
+    const MatBitmapConversionOptions& GetConversionOptions() const { return m_conversionOptions; }
+
+    size_t GetFileSize() const { return m_size; }
+
+    // Returns true for file extensions of formats Open() may support.
+    static bool IsSupportedFileName(const wxString& fileName);
+
+private:
+    const uchar*               m_data{nullptr};
+    size_t                     m_size{0};
+    cv::Mat                    m_matBitmap;
+    MatBitmapConversionOptions m_conversionOptions;
+
+    bool Map(const wxString& fileName, wxString& errorMessage);
+    bool WrapBMP(wxString& errorMessage);
+    bool WrapPNM(wxString& errorMessage);
+    bool WrapPixels(int width, int height, int type, size_t rowStride, size_t offset, wxString& errorMessage);
+
+    wxDECLARE_NO_COPY_CLASS(MappedImage);
+};
+
+#endif // #ifndef MAPPEDIMAGE_H
@@ -0,0 +1,1201 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        ocvbench.cpp
+// Purpose:     Benchmarks and verifies wxTestOpenCV conversions
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// A command line program measuring how long the conversions take
+// for various resolutions, Mat types, continuous and ROI Mats,
+// and numbers of threads converting at the same time.
+// The results are written as JSON, so that they can be compared
+// between builds. With --baseline, the results are compared with
+// those from a previous run and the program fails if any case
+// got slower by more than the tolerance. The comparison is done only
+// in Release builds and with a baseline measured in a Release build,
+// otherwise the program exits with SkipExitCode.
+//
+// With --verify, the program instead checks that all conversion
+// paths produce the same results as a reference implementation
+// using only OpenCV functions, for all supported types,
+// odd sizes, single row and column, and ROI Mats, and that converting
+// only the changed tiles of a frame gives the same result as converting
+// the whole frame.
+//
+// By default, only the paths not requiring GUI are measured
+// (e.g., Mat to wxImage), so the program can run headless.
+// Use --bitmap to include wxBitmap paths, these need GUI
+// (e.g., an X server or Xvfb on Linux) and are always run
+// in the main thread only.
+//
+// With --export, the program instead measures how the throughput
+// of the frame-parallel video export (see VideoExportJob) scales
+// with the number of worker threads.
+//
+// With --load, the program instead compares loading and converting
+// an image file memory-mapped (see MappedImage) and with cv::imread(),
+// reporting the time and peak resident memory of both.
+//
+// With --ring, the program instead measures the throughput and latency
+// of passing FHD frames through a shared-memory frame ring (see
+// SharedFrameRingProducer) from a producer thread to a consumer thread
+// converting them to wxImage, for both policies of a full ring.
+//
+// With --stats, the program instead measures computing the frame
+// statistics (see ComputeFrameStatistics()) with several sampling grids
+// and checks their histograms against cv::calcHist().
+//
+// With --decode, the program instead decodes a local video file with each
+// available backend and number of decoder threads (see VideoCaptureOptions),
+// reporting the throughput and the CPU time used.
+//
+// With --paint, the program instead measures converting FHD and 4K frames
+// and drawing them as wxBitmapFromOpenCVPanel does on wxGTK3, once via
+// wxBitmap and once via a cairo image surface (needs GUI).
+//
+// The modes other than the conversion benchmark and --verify are
+// implemented in their own files (e.g., ocvbenchexport.cpp), declared
+// in ocvbench.h, and report their results through BenchJSONWriter.
+
+#include <wx/wx.h>
+#include <wx/cmdline.h>
+#include <wx/ffile.h>
+#include <wx/init.h>
+#include <wx/regex.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#ifdef __WXGTK3__
+    #include <cairo.h>
+#endif
+
+#include "convertmattowxbmp.h"
+#include "ocvbench.h"
+#include "videocaptureoptions.h"
+
+namespace
+{
+
+// Performs a single conversion, owns its destination.
+typedef std::function<bool()> Converter;
+
+struct ConversionPath
+{
+    const char* name;
+    // wxBitmap paths need GUI and must not be used from other threads.
+    bool        needsGUI;
+    // Paths converting to Mat use a CV_8UC3 Mat only to create their source.
+    bool        convertsToMat;
+    // Whether the path can convert from the given Mat type.
+    bool        (*supportsType)(int type);
+    // Creates a converter for matBitmap, bytesPerPixel is set to
+    // the number of bytes read and written for a single pixel.
+    Converter   (*createConverter)(const cv::Mat& matBitmap, double& bytesPerPixel);
+};
+
+bool AnySupportedType(int type)
+{
+    return GetwxBitmapDepthForMatBitmap(cv::Mat(1, 1, type)) != 0;
+}
+
+bool OnlyBGRType(int type)
+{
+    return type == CV_8UC3;
+}
+
+Converter CreateMatTowxImage(const cv::Mat& matBitmap, double& bytesPerPixel)
+{
+    std::shared_ptr<wxImage> image = std::make_shared<wxImage>(matBitmap.cols, matBitmap.rows, false);
+
+    bytesPerPixel = matBitmap.elemSize() + (matBitmap.type() == CV_8UC4 ? 4 : 3);
+    return [matBitmap, image]() { return ConvertMatBitmapTowxImage(matBitmap, *image); };
+}
+
+Converter CreatewxImageToMat(const cv::Mat& matBitmap, double& bytesPerPixel)
+{
+    std::shared_ptr<wxImage> image = std::make_shared<wxImage>(matBitmap.cols, matBitmap.rows, false);
+    std::shared_ptr<cv::Mat> result = std::make_shared<cv::Mat>();
+
+    if ( !ConvertMatBitmapTowxImage(matBitmap, *image) )
+        return Converter();
+
+    bytesPerPixel = 3 + 3;
+    return [image, result]() { return ConvertwxImageToMatBitmap(*image, *result); };
+}
+
+Converter CreateMatTowxBitmap(const cv::Mat& matBitmap, double& bytesPerPixel)
+{
+    const int                 depth = GetwxBitmapDepthForMatBitmap(matBitmap);
+    std::shared_ptr<wxBitmap> bitmap = std::make_shared<wxBitmap>(matBitmap.cols, matBitmap.rows, depth);
+
+    bytesPerPixel = matBitmap.elemSize() + depth / 8;
+    return [matBitmap, bitmap]() { return ConvertMatBitmapTowxBitmap(matBitmap, *bitmap); };
+}
+
+Converter CreatewxBitmapToMat(const cv::Mat& matBitmap, double& bytesPerPixel)
+{
+    std::shared_ptr<wxBitmap> bitmap = std::make_shared<wxBitmap>(matBitmap.cols, matBitmap.rows, 24);
+    std::shared_ptr<cv::Mat>  result = std::make_shared<cv::Mat>();
+
+    if ( !ConvertMatBitmapTowxBitmap(matBitmap, *bitmap) )
+        return Converter();
+
+    bytesPerPixel = 3 + 3;
+    return [bitmap, result]() { return ConvertwxBitmapToMatBitmap(*bitmap, *result); };
+}
+
+#ifdef __WXGTK3__
+
+Converter CreateMatToCairoSurface(const cv::Mat& matBitmap, double& bytesPerPixel)
+{
+    const cairo_format_t             format = matBitmap.type() == CV_8UC4 ? CAIRO_FORMAT_ARGB32 : CAIRO_FORMAT_RGB24;
+    std::shared_ptr<cairo_surface_t> surface(cairo_image_surface_create(format, matBitmap.cols, matBitmap.rows),
+                                             cairo_surface_destroy);
+
+    bytesPerPixel = matBitmap.elemSize() + 4;
+    return [matBitmap, surface]() { return ConvertMatBitmapToCairoSurface(matBitmap, surface.get()); };
+}
+
+#endif // #ifdef __WXGTK3__
+
+const ConversionPath ConversionPaths[] =
+{
+    { "MatTowxImage",      false, false, AnySupportedType, CreateMatTowxImage },
+    { "wxImageToMat",      false, true,  OnlyBGRType,      CreatewxImageToMat },
+#ifdef __WXGTK3__
+    { "MatToCairoSurface", false, false, AnySupportedType, CreateMatToCairoSurface },
+#endif
+    { "MatTowxBitmap",     true,  false, AnySupportedType, CreateMatTowxBitmap },
+    { "wxBitmapToMat",     true,  true,  OnlyBGRType,      CreatewxBitmapToMat },
+};
+
+struct CaseResult
+{
+    size_t iterations{0};
+    double meanMs{0.};
+    double minMs{0.};
+    double varianceMs2{0.};
+    double nsPerPixel{0.};
+    double gbPerSec{0.};
+};
+
+// Runs the conversion in threadCount threads at the same time,
+// each thread converts at least MinIterations times and for at least minTimeMs.
+bool RunCase(const ConversionPath& path, const cv::Mat& matBitmap,
+             int threadCount, long minTimeMs, CaseResult& result)
+{
+    std::vector<Converter> converters;
+    double                 bytesPerPixel = 0.;
+
+    for ( int i = 0; i < threadCount; ++i )
+    {
+        Converter converter = path.createConverter(matBitmap, bytesPerPixel);
+
+        // warm up and check that the conversion works at all
+        if ( !converter || !converter() )
+            return false;
+
+        converters.push_back(converter);
+    }
+
+    std::vector<std::vector<double>> samples(threadCount); // in ms
+    std::vector<std::thread>         threads;
+    std::atomic<bool>                start(false);
+    std::atomic<bool>                failed(false);
+    wxStopWatch                      wallStopWatch;
+
+    auto work = [&](int index)
+    {
+        while ( !start )
+            std::this_thread::yield();
+
+        wxStopWatch totalStopWatch;
+        wxStopWatch stopWatch;
+
+        do
+        {
+            stopWatch.Start();
+            if ( !converters[index]() )
+                failed = true;
+            samples[index].push_back(stopWatch.TimeInMicro().ToDouble() / 1000.);
+        } while ( totalStopWatch.Time() < minTimeMs || samples[index].size() < MinIterations );
+    };
+
+    if ( path.needsGUI )
+    {
+        start = true;
+        wallStopWatch.Start();
+        work(0);
+    }
+    else
+    {
+        for ( int i = 0; i < threadCount; ++i )
+            threads.emplace_back(work, i);
+
+        wallStopWatch.Start();
+        start = true;
+
+        for ( auto& t : threads )
+            t.join();
+    }
+
+    const double wallMs = wallStopWatch.TimeInMicro().ToDouble() / 1000.;
+
+    if ( failed )
+        return false;
+
+    double sum = 0., sumSquares = 0., minMs = 0.;
+    size_t count = 0;
+
+    minMs = samples[0][0];
+    for ( const auto& threadSamples : samples )
+    {
+        for ( const double ms : threadSamples )
+        {
+            sum += ms;
+            minMs = std::min(minMs, ms);
+            ++count;
+        }
+    }
+
+    result.iterations = count;
+    result.meanMs = sum / count;
+    result.minMs = minMs;
+
+    for ( const auto& threadSamples : samples )
+    {
+        for ( const double ms : threadSamples )
+            sumSquares += (ms - result.meanMs) * (ms - result.meanMs);
+    }
+
+    const double pixels = static_cast<double>(matBitmap.cols) * matBitmap.rows;
+
+    result.varianceMs2 = count > 1 ? sumSquares / (count - 1) : 0.;
+    result.nsPerPixel = result.meanMs * 1e6 / pixels;
+    // aggregate throughput of all threads
+    result.gbPerSec = wallMs > 0. ? (pixels * bytesPerPixel * count) / (wallMs * 1e6) : 0.;
+
+    return true;
+}
+
+//
+// Verification of the conversion results against a reference
+// conversion implemented using only OpenCV functions
+//
+
+struct VerifySize
+{
+    int width;
+    int height;
+};
+
+// Include odd widths, single row and column, and sizes
+// not handled by the MSW-optimized version (width % 4 != 0).
+const VerifySize VerifySizes[] =
+{
+    {    1,    1 },
+    {   17,    1 },
+    {    1,   17 },
+    {    3,    5 },
+    {    7,   13 },
+    {  641,  479 },
+    { 1920, 1080 },
+};
+
+// Only CV_8UC3 is verified with this size, to keep the time reasonable.
+const VerifySize VerifyLargeSize = { 7680, 4320 };
+
+enum VerifyOptions
+{
+    VerifyDefault,
+    VerifyScaleOffset,
+    VerifyNormalize,
+    VerifyColormap,
+    VerifyLayout,   // bottom-up RGB(A) with unused fourth channel
+};
+
+MatBitmapConversionOptions GetVerifyOptions(VerifyOptions verifyOptions, int depth)
+{
+    MatBitmapConversionOptions options;
+
+    switch ( verifyOptions )
+    {
+        case VerifyDefault:
+            break;
+        case VerifyScaleOffset:
+            options.scale = depth == CV_16U ? 1. / 512. : (depth == CV_32F ? 127. : .5);
+            options.offset = 10.;
+            break;
+        case VerifyNormalize:
+            options.normalize = true;
+            break;
+        case VerifyColormap:
+            options.colormap = cv::COLORMAP_JET;
+            break;
+        case VerifyLayout:
+            options.flipVertically = true;
+            options.swapRedBlue = true;
+            options.ignoreAlpha = true;
+            break;
+    }
+
+    return options;
+}
+
+// Computes the expected result as BGR CV_8UC3 and, for CV_8UC4 Mats, alpha CV_8UC1.
+void ConvertReference(const cv::Mat& matBitmap, const MatBitmapConversionOptions& options,
+                      cv::Mat& bgr, cv::Mat& alpha)
+{
+    const int depth = matBitmap.depth();
+    double    scale = options.scale;
+    double    offset = options.offset;
+    cv::Mat   source = matBitmap, mapped;
+
+    if ( options.flipVertically )
+        cv::flip(matBitmap, source, 0);
+
+    if ( options.swapRedBlue && source.channels() == 3 )
+        cv::cvtColor(source, source, cv::COLOR_RGB2BGR);
+    else if ( options.swapRedBlue && source.channels() == 4 )
+        cv::cvtColor(source, source, cv::COLOR_RGBA2BGRA);
+
+    if ( options.normalize )
+    {
+        double minVal = 0., maxVal = 0.;
+
+        cv::minMaxIdx(source.reshape(1), &minVal, &maxVal);
+        scale = maxVal > minVal ? 255. / (maxVal - minVal) : 1.;
+        offset = -minVal * scale;
+    }
+    else if ( scale == 0. )
+    {
+        scale = depth == CV_16U ? 1. / 256. : (depth == CV_32F ? 255. : 1.);
+    }
+
+    source.convertTo(mapped, CV_8U, scale, offset);
+    alpha.release();
+
+    switch ( matBitmap.channels() )
+    {
+        case 1:
+            if ( options.colormap >= 0 )
+                cv::applyColorMap(mapped, bgr, options.colormap);
+            else
+                cv::cvtColor(mapped, bgr, cv::COLOR_GRAY2BGR);
+            break;
+        case 3:
+            bgr = mapped;
+            break;
+        case 4:
+            cv::cvtColor(mapped, bgr, cv::COLOR_BGRA2BGR);
+            if ( !options.ignoreAlpha )
+                cv::extractChannel(source, alpha, 3);
+            break;
+    }
+}
+
+// Returns the maximum difference between channel values of a and b
+// or 256 if they differ in size or type.
+int GetMaxDifference(const cv::Mat& a, const cv::Mat& b)
+{
+    if ( a.size() != b.size() || a.type() != b.type() )
+        return 256;
+
+    if ( a.empty() )
+        return 0;
+
+    cv::Mat diff;
+    double  maxDiff = 0.;
+
+    cv::absdiff(a, b, diff);
+    cv::minMaxIdx(diff.reshape(1), nullptr, &maxDiff);
+
+    return static_cast<int>(maxDiff);
+}
+
+// Returns BGR (and alpha, if the image has it) Mats with the image data.
+void GetImageBGRAndAlpha(const wxImage& image, cv::Mat& bgr, cv::Mat& alpha)
+{
+    const cv::Mat rgb(image.GetHeight(), image.GetWidth(), CV_8UC3, image.GetData());
+
+    cv::cvtColor(rgb, bgr, cv::COLOR_RGB2BGR);
+
+    if ( image.HasAlpha() )
+        cv::Mat(image.GetHeight(), image.GetWidth(), CV_8UC1, image.GetAlpha()).copyTo(alpha);
+    else
+        alpha.release();
+}
+
+// Contains the results of all verified cases.
+class Verifier
+{
+public:
+    // tolerance is the allowed maximum difference of channel values
+    void Check(int maxDifference, int tolerance, const wxString& description)
+    {
+        ++m_caseCount;
+
+        if ( maxDifference <= tolerance )
+            return;
+
+        ++m_failedCount;
+        fprintf(stderr, "FAILED: %s (max difference %d, tolerance %d)\n",
+                static_cast<const char*>(description.utf8_str()), maxDifference, tolerance);
+    }
+
+    void CheckTrue(bool condition, const wxString& description)
+    {
+        Check(condition ? 0 : 256, 0, description);
+    }
+
+    int GetCaseCount() const   { return m_caseCount; }
+    int GetFailedCount() const { return m_failedCount; }
+
+private:
+    int m_caseCount{0};
+    int m_failedCount{0};
+};
+
+void VerifyMatToImage(Verifier& verifier, const cv::Mat& matBitmap,
+                      const MatBitmapConversionOptions& options,
+                      const cv::Mat& expectedBGR, const cv::Mat& expectedAlpha,
+                      int tolerance, const wxString& description)
+{
+    wxImage image(matBitmap.cols, matBitmap.rows, false);
+    cv::Mat bgr, alpha;
+
+    verifier.CheckTrue(ConvertMatBitmapTowxImage(matBitmap, image, options), "MatTowxImage converts " + description);
+    GetImageBGRAndAlpha(image, bgr, alpha);
+    verifier.Check(GetMaxDifference(bgr, expectedBGR), tolerance, "MatTowxImage colour " + description);
+    verifier.Check(GetMaxDifference(alpha, expectedAlpha), 0, "MatTowxImage alpha " + description);
+
+    // round trip, only for types without value mapping and in the usual layout
+    if ( options.colormap < 0 && !options.flipVertically && !options.swapRedBlue && !options.ignoreAlpha
+         && (matBitmap.type() == CV_8UC3 || matBitmap.type() == CV_8UC4) )
+    {
+        cv::Mat roundTrip;
+
+        verifier.CheckTrue(ConvertwxImageToMatBitmap(image, roundTrip), "wxImageToMat converts " + description);
+        if ( tolerance == 0 )
+            verifier.Check(GetMaxDifference(roundTrip, matBitmap), 0, "MatTowxImage -> wxImageToMat " + description);
+
+        if ( !image.HasAlpha() )
+        {
+            cv::Mat shared;
+
+            ConvertwxImageToMatBitmap(image, shared, true);
+            verifier.CheckTrue(shared.data == image.GetData(), "wxImageToMat shares data " + description);
+
+            cv::Mat sharedBGR;
+
+            cv::cvtColor(shared, sharedBGR, cv::COLOR_RGB2BGR);
+            verifier.Check(GetMaxDifference(sharedBGR, bgr), 0, "wxImageToMat shared data " + description);
+        }
+    }
+}
+
+#ifdef __WXGTK3__
+
+void VerifyMatToCairoSurface(Verifier& verifier, const cv::Mat& matBitmap,
+                             const MatBitmapConversionOptions& options,
+                             const cv::Mat& expectedBGR, const cv::Mat& expectedAlpha,
+                             int tolerance, const wxString& description)
+{
+    const bool       hasAlpha = !expectedAlpha.empty();
+    cairo_surface_t* surface = cairo_image_surface_create(hasAlpha ? CAIRO_FORMAT_ARGB32 : CAIRO_FORMAT_RGB24,
+                                                           matBitmap.cols, matBitmap.rows);
+
+    verifier.CheckTrue(ConvertMatBitmapToCairoSurface(matBitmap, surface, options),
+                       "MatToCairoSurface converts " + description);
+    cairo_surface_flush(surface);
+
+    // cairo stores a pixel as a native-endian 32-bit ARGB value
+    const uchar* data = cairo_image_surface_get_data(surface);
+    const int    stride = cairo_image_surface_get_stride(surface);
+    cv::Mat      bgr(matBitmap.rows, matBitmap.cols, CV_8UC3), alpha;
+    cv::Mat      expected = expectedBGR;
+
+    if ( hasAlpha )
+        alpha.create(matBitmap.rows, matBitmap.cols, CV_8UC1);
+
+    for ( int row = 0; row < matBitmap.rows; ++row )
+    {
+        const uint32_t* argb = reinterpret_cast<const uint32_t*>(data + row * stride);
+
+        for ( int col = 0; col < matBitmap.cols; ++col )
+        {
+            cv::Vec3b& pixel = bgr.at<cv::Vec3b>(row, col);
+
+            pixel[0] = static_cast<uchar>(argb[col] & 0xFF);
+            pixel[1] = static_cast<uchar>((argb[col] >> 8) & 0xFF);
+            pixel[2] = static_cast<uchar>((argb[col] >> 16) & 0xFF);
+            if ( hasAlpha )
+                alpha.at<uchar>(row, col) = static_cast<uchar>(argb[col] >> 24);
+        }
+    }
+
+    cairo_surface_destroy(surface);
+
+    if ( hasAlpha ) // ARGB32 is premultiplied
+    {
+        cv::Mat alpha3;
+
+        cv::cvtColor(expectedAlpha, alpha3, cv::COLOR_GRAY2BGR);
+        cv::multiply(expectedBGR, alpha3, expected, 1. / 255.);
+        tolerance = std::max(tolerance, 1);
+    }
+
+    verifier.Check(GetMaxDifference(bgr, expected), tolerance, "MatToCairoSurface colour " + description);
+    if ( hasAlpha )
+        verifier.Check(GetMaxDifference(alpha, expectedAlpha), 0, "MatToCairoSurface alpha " + description);
+}
+
+#endif // #ifdef __WXGTK3__
+
+void VerifyMatToBitmap(Verifier& verifier, const cv::Mat& matBitmap,
+                       const MatBitmapConversionOptions& options,
+                       const cv::Mat& expectedBGR, const cv::Mat& expectedAlpha,
+                       int tolerance, const wxString& description)
+{
+    wxBitmap bitmap(matBitmap.cols, matBitmap.rows, GetwxBitmapDepthForMatBitmap(matBitmap, options));
+    cv::Mat  bgr, alpha;
+
+    verifier.CheckTrue(ConvertMatBitmapTowxBitmap(matBitmap, bitmap, options), "MatTowxBitmap converts " + description);
+
+    if ( expectedAlpha.empty() )
+    {
+        // wxBitmap::ConvertToImage() does not use any of our code
+        GetImageBGRAndAlpha(bitmap.ConvertToImage(), bgr, alpha);
+        verifier.Check(GetMaxDifference(bgr, expectedBGR), tolerance, "MatTowxBitmap colour " + description);
+
+        cv::Mat roundTrip;
+
+        verifier.CheckTrue(ConvertwxBitmapToMatBitmap(bitmap, roundTrip), "wxBitmapToMat converts " + description);
+        verifier.Check(GetMaxDifference(roundTrip, expectedBGR), tolerance, "MatTowxBitmap -> wxBitmapToMat " + description);
+        return;
+    }
+
+    // Alpha may be stored premultiplied, which loses precision, particularly
+    // for low alpha values, so compare the colours only for mostly opaque pixels.
+    cv::Mat roundTrip, roundTripBGR, mask, roundTripAlpha;
+
+    verifier.CheckTrue(ConvertwxBitmapToMatBitmap(bitmap, roundTrip), "wxBitmapToMat converts " + description);
+    if ( roundTrip.type() != CV_8UC4 )
+    {
+        verifier.CheckTrue(false, "wxBitmapToMat keeps alpha " + description);
+        return;
+    }
+
+    cv::cvtColor(roundTrip, roundTripBGR, cv::COLOR_BGRA2BGR);
+    cv::extractChannel(roundTrip, roundTripAlpha, 3);
+    verifier.Check(GetMaxDifference(roundTripAlpha, expectedAlpha), 0, "MatTowxBitmap -> wxBitmapToMat alpha " + description);
+
+    mask = expectedAlpha < 128;
+    roundTripBGR.setTo(cv::Scalar::all(0), mask);
+
+    cv::Mat expectedMasked = expectedBGR.clone();
+
+    expectedMasked.setTo(cv::Scalar::all(0), mask);
+    verifier.Check(GetMaxDifference(roundTripBGR, expectedMasked), std::max(tolerance, 2),
+                   "MatTowxBitmap -> wxBitmapToMat colour " + description);
+}
+
+void IgnoreAssertHandler(const wxString&, int, const wxString&, const wxString&, const wxString&)
+{
+}
+
+// ConvertMatBitmapTowxImage() does not create the image, callers must
+// pass one of the Mat size. Checks that it refuses to convert into
+// an image which was not created, instead of silently succeeding.
+void VerifyImageMustBeCreated(Verifier& verifier)
+{
+    const cv::Mat matBitmap = CreateSourceMat(64, 48, CV_8UC3, false);
+    wxImage       image;
+
+    // the conversion asserts in debug builds, which is expected here
+    wxAssertHandler_t oldAssertHandler = wxSetAssertHandler(IgnoreAssertHandler);
+    const bool        converted = ConvertMatBitmapTowxImage(matBitmap, image);
+
+    wxSetAssertHandler(oldAssertHandler);
+
+    verifier.CheckTrue(!converted && !image.IsOk(), "MatTowxImage rejects an image not created");
+
+    image.Create(matBitmap.cols, matBitmap.rows, false);
+    verifier.CheckTrue(ConvertMatBitmapTowxImage(matBitmap, image), "MatTowxImage converts into an image created at the Mat size");
+}
+
+// Size of the Mat for verifying the tile updates, neither dimension
+// is a multiple of VerifyTileSize, so the tiles in the last column
+// and row are smaller.
+const VerifySize VerifyTilesSize = { 100, 70 };
+const int        VerifyTileSize  = 32;
+
+// Sets the pixel to a value far from the current one.
+void ChangePixel(cv::Mat& matBitmap, int x, int y)
+{
+    const int    depth = matBitmap.depth();
+    const double maxVal = depth == CV_8U ? 255. : (depth == CV_16U ? 65535. : 1.);
+    cv::Mat      pixel = matBitmap(cv::Rect(x, y, 1, 1)), value;
+
+    pixel.convertTo(value, CV_64F);
+    pixel.setTo(cv::Scalar::all(value.at<double>(0) > maxVal / 2. ? 0. : maxVal));
+}
+
+#ifdef __WXGTK3__
+
+// Returns a copy of the surface data as CV_8UC4.
+cv::Mat GetCairoSurfaceData(cairo_surface_t* surface)
+{
+    cairo_surface_flush(surface);
+
+    return cv::Mat(cairo_image_surface_get_height(surface), cairo_image_surface_get_width(surface), CV_8UC4,
+                   cairo_image_surface_get_data(surface), cairo_image_surface_get_stride(surface)).clone();
+}
+
+#endif // #ifdef __WXGTK3__
+
+// Checks that GetChangedMatBitmapTiles() finds the changed tiles,
+// including the smaller ones at the edges, and merges the adjacent ones,
+// and that converting only these tiles of a frame over the previous one
+// gives the same result as converting the whole frame.
+void VerifyTileUpdates(Verifier& verifier, bool useBitmaps)
+{
+    const int width = VerifyTilesSize.width;
+    const int height = VerifyTilesSize.height;
+
+    // Two adjacent tiles in the first row, a single tile in the last column,
+    // and two tiles in the last (ragged) row which are not adjacent.
+    const cv::Point changedPixels[] = { { 5, 5 }, { 40, 10 }, { width - 1, 40 }, { 10, height - 1 }, { width - 1, height - 1 } };
+    const std::vector<wxRect> expectedTiles =
+    {
+        wxRect( 0,  0, 64, 32),
+        wxRect(96, 32,  4, 32),
+        wxRect( 0, 64, 32,  6),
+        wxRect(96, 64,  4,  6),
+    };
+
+    for ( const int type : MatTypes )
+    {
+        for ( const bool roi : { false, true } )
+        {
+            const cv::Mat previous = CreateSourceMat(width, height, type, roi);
+            cv::Mat       current = CreateSourceMat(width, height, type, roi);
+
+            previous.copyTo(current);
+            for ( const cv::Point& point : changedPixels )
+                ChangePixel(current, point.x, point.y);
+
+            const wxString description = wxString::Format("%dx%d %s%s",
+                width, height, wxString(cv::typeToString(type)), roi ? " ROI" : "");
+            std::vector<wxRect> tiles;
+
+            verifier.CheckTrue(GetChangedMatBitmapTiles(current, previous, VerifyTileSize, 0., tiles)
+                               && tiles == expectedTiles, "GetChangedMatBitmapTiles finds tiles " + description);
+            verifier.CheckTrue(GetChangedMatBitmapTiles(current, previous, VerifyTileSize, .25, tiles)
+                               && tiles == expectedTiles, "GetChangedMatBitmapTiles finds tiles with threshold " + description);
+            verifier.CheckTrue(GetChangedMatBitmapTiles(previous, previous, VerifyTileSize, 0., tiles)
+                               && tiles.empty(), "GetChangedMatBitmapTiles finds no tiles " + description);
+
+            for ( const VerifyOptions verifyOptions : { VerifyDefault, VerifyScaleOffset } )
+            {
+                const MatBitmapConversionOptions options = GetVerifyOptions(verifyOptions, current.depth());
+                const wxString optionsDescription = wxString::Format("%s, options %d", description, static_cast<int>(verifyOptions));
+
+#ifdef __WXGTK3__
+                const cairo_format_t format = type == CV_8UC4 ? CAIRO_FORMAT_ARGB32 : CAIRO_FORMAT_RGB24;
+                cairo_surface_t*     updatedSurface = cairo_image_surface_create(format, width, height);
+                cairo_surface_t*     fullSurface = cairo_image_surface_create(format, width, height);
+
+                verifier.CheckTrue(ConvertMatBitmapToCairoSurface(previous, updatedSurface, options)
+                                   && ConvertMatBitmapToCairoSurface(current, updatedSurface, expectedTiles, options)
+                                   && ConvertMatBitmapToCairoSurface(current, fullSurface, options),
+                                   "MatToCairoSurface converts tiles " + optionsDescription);
+                verifier.Check(GetMaxDifference(GetCairoSurfaceData(updatedSurface), GetCairoSurfaceData(fullSurface)), 0,
+                               "MatToCairoSurface tiles " + optionsDescription);
+
+                cairo_surface_destroy(fullSurface);
+                cairo_surface_destroy(updatedSurface);
+#endif // #ifdef __WXGTK3__
+
+                if ( !useBitmaps )
+                    continue;
+
+                const int depth = GetwxBitmapDepthForMatBitmap(current, options);
+                wxBitmap  updated(width, height, depth), full(width, height, depth);
+                cv::Mat   updatedBGR, updatedAlpha, fullBGR, fullAlpha;
+
+                verifier.CheckTrue(ConvertMatBitmapTowxBitmap(previous, updated, options)
+                                   && ConvertMatBitmapTowxBitmap(current, updated, expectedTiles, options)
+                                   && ConvertMatBitmapTowxBitmap(current, full, options),
+                                   "MatTowxBitmap converts tiles " + optionsDescription);
+                GetImageBGRAndAlpha(updated.ConvertToImage(), updatedBGR, updatedAlpha);
+                GetImageBGRAndAlpha(full.ConvertToImage(), fullBGR, fullAlpha);
+                verifier.Check(GetMaxDifference(updatedBGR, fullBGR), 0, "MatTowxBitmap tiles colour " + optionsDescription);
+                verifier.Check(GetMaxDifference(updatedAlpha, fullAlpha), 0, "MatTowxBitmap tiles alpha " + optionsDescription);
+            }
+        }
+    }
+}
+
+// Returns the number of failed cases.
+int VerifyConversions(bool useBitmaps)
+{
+    Verifier verifier;
+
+    VerifyImageMustBeCreated(verifier);
+    VerifyTileUpdates(verifier, useBitmaps);
+
+    std::vector<VerifySize> sizes(std::begin(VerifySizes), std::end(VerifySizes));
+
+    sizes.push_back(VerifyLargeSize);
+
+    for ( const auto& size : sizes )
+    {
+        const bool isLarge = size.width == VerifyLargeSize.width && size.height == VerifyLargeSize.height;
+
+        for ( const int type : MatTypes )
+        {
+            if ( isLarge && type != CV_8UC3 )
+                continue;
+
+            for ( const bool roi : { false, true } )
+            {
+                const cv::Mat matBitmap = CreateSourceMat(size.width, size.height, type, roi);
+
+                for ( const VerifyOptions verifyOptions : { VerifyDefault, VerifyScaleOffset, VerifyNormalize,
+                                                            VerifyColormap, VerifyLayout } )
+                {
+                    if ( verifyOptions == VerifyColormap && matBitmap.channels() != 1 )
+                        continue;
+
+                    const MatBitmapConversionOptions options = GetVerifyOptions(verifyOptions, matBitmap.depth());
+                    const wxString description = wxString::Format("%dx%d %s%s, options %d",
+                        size.width, size.height, wxString(cv::typeToString(type)), roi ? " ROI" : "", static_cast<int>(verifyOptions));
+                    // Values are mapped with float arithmetic, which may
+                    // differ by one from the reference when rounding.
+                    const int tolerance = matBitmap.depth() == CV_8U
+                                          && (verifyOptions == VerifyDefault || verifyOptions == VerifyLayout) ? 0 : 1;
+                    cv::Mat   expectedBGR, expectedAlpha;
+
+                    ConvertReference(matBitmap, options, expectedBGR, expectedAlpha);
+
+                    VerifyMatToImage(verifier, matBitmap, options, expectedBGR, expectedAlpha, tolerance, description);
+#ifdef __WXGTK3__
+                    VerifyMatToCairoSurface(verifier, matBitmap, options, expectedBGR, expectedAlpha, tolerance, description);
+#endif
+                    if ( useBitmaps )
+                        VerifyMatToBitmap(verifier, matBitmap, options, expectedBGR, expectedAlpha, tolerance, description);
+                }
+            }
+        }
+    }
+
+    fprintf(stderr, "Verified %d cases, %d failed.\n", verifier.GetCaseCount(), verifier.GetFailedCount());
+
+    return verifier.GetFailedCount();
+}
+
+//
+// Comparison of the benchmark results with a baseline
+//
+
+// Identifies a benchmark case.
+wxString GetCaseKey(const wxString& path, const wxString& resolution, const wxString& type,
+                    bool roi, long threadCount)
+{
+    return wxString::Format("%s %s %s%s, %ld thread(s)", path, resolution, type, roi ? " ROI" : "", threadCount);
+}
+
+// Exit code telling ctest that the test was skipped, see SKIP_RETURN_CODE in CMakeLists.txt.
+const int SkipExitCode = 77;
+
+// Reads nsPerPixel for each case and the build type the results
+// were measured in from JSON previously written by this program.
+bool ReadBaseline(const wxString& fileName, std::map<wxString, double>& baseline, wxString& buildType)
+{
+    wxFFile  file(fileName, "r");
+    wxString content;
+
+    if ( !file.IsOpened() || !file.ReadAll(&content) )
+        return false;
+
+    // The program writes each result on a separate line.
+    wxRegEx resultRegEx("\"path\": \"([^\"]*)\", \"resolution\": \"([^\"]*)\".*\"type\": \"([^\"]*)\", "
+                        "\"roi\": (true|false), \"threads\": ([0-9]+).*\"nsPerPixel\": ([0-9.]+)");
+
+    wxRegEx buildTypeRegEx("\"buildType\": \"([^\"]*)\"");
+
+    wxCHECK(resultRegEx.IsValid() && buildTypeRegEx.IsValid(), false);
+
+    buildType.clear();
+
+    for ( const auto& line : wxSplit(content, '\n') )
+    {
+        if ( buildTypeRegEx.Matches(line) )
+            buildType = buildTypeRegEx.GetMatch(line, 1);
+
+        long   threadCount = 0;
+        double nsPerPixel = 0.;
+
+        if ( !resultRegEx.Matches(line)
+             || !resultRegEx.GetMatch(line, 5).ToLong(&threadCount)
+             || !resultRegEx.GetMatch(line, 6).ToCDouble(&nsPerPixel) )
+        {
+            continue;
+        }
+
+        baseline[GetCaseKey(resultRegEx.GetMatch(line, 1), resultRegEx.GetMatch(line, 2),
+                            resultRegEx.GetMatch(line, 3), resultRegEx.GetMatch(line, 4) == "true",
+                            threadCount)] = nsPerPixel;
+    }
+
+    return !baseline.empty();
+}
+
+} // unnamed namespace
+
+
+int main(int argc, char** argv)
+{
+    // wxBitmap needs GUI, which may not be available (e.g., when
+    // running headless), so it is initialized only when requested.
+    for ( int i = 1; i < argc; ++i )
+    {
+        if ( strcmp(argv[i], "--bitmap") == 0 || strcmp(argv[i], "--paint") == 0 )
+        {
+            wxApp::SetInstance(new wxApp);
+            break;
+        }
+    }
+
+    wxInitializer initializer(argc, argv);
+
+    if ( !initializer.IsOk() )
+    {
+        fprintf(stderr, "Could not initialize wxWidgets.\n");
+        return 1;
+    }
+
+    static const wxCmdLineEntryDesc cmdLineDesc[] =
+    {
+        { wxCMD_LINE_SWITCH, "h", "help", "show this help message",
+            wxCMD_LINE_VAL_NONE, wxCMD_LINE_OPTION_HELP },
+        { wxCMD_LINE_OPTION, "r", "resolutions", "comma-separated resolutions (VGA, HD, FHD, 4K, 8K), all by default" },
+        { wxCMD_LINE_OPTION, "t", "types", "comma-separated Mat types (e.g., CV_8UC3), all supported by default" },
+        { wxCMD_LINE_OPTION, "p", "paths", "comma-separated conversion paths, all available by default" },
+        { wxCMD_LINE_OPTION, "n", "threads", "comma-separated numbers of threads, 1,2,4 by default" },
+        { wxCMD_LINE_OPTION, "m", "min-time", "minimum time per case and thread in ms, 200 by default",
+            wxCMD_LINE_VAL_NUMBER },
+        { wxCMD_LINE_OPTION, "o", "output", "file to write JSON results to, standard output by default" },
+        { wxCMD_LINE_SWITCH, nullptr, "bitmap", "include wxBitmap conversion paths (needs GUI)" },
+        { wxCMD_LINE_SWITCH, nullptr, "verify", "verify conversion results instead of benchmarking" },
+        { wxCMD_LINE_OPTION, "b", "baseline", "JSON file with results to compare with" },
+        { wxCMD_LINE_OPTION, nullptr, "tolerance", "allowed slowdown compared to baseline in percent, 20 by default",
+            wxCMD_LINE_VAL_NUMBER },
+        { wxCMD_LINE_SWITCH, nullptr, "export", "benchmark video export with numbers of workers given by --threads" },
+        { wxCMD_LINE_OPTION, nullptr, "video", "video file for --export, a generated one by default" },
+        { wxCMD_LINE_OPTION, nullptr, "frames", "number of frames for --export (200 by default) or --decode (all by default)",
+            wxCMD_LINE_VAL_NUMBER },
+        { wxCMD_LINE_OPTION, nullptr, "load", "image file to compare memory-mapped loading with cv::imread() for" },
+        { wxCMD_LINE_OPTION, nullptr, "layout", "layout of a raw image for --load, e.g., \"1920x1080 8UC3\"" },
+        { wxCMD_LINE_SWITCH, nullptr, "ring", "benchmark passing frames through a shared-memory frame ring" },
+        { wxCMD_LINE_SWITCH, nullptr, "stats", "benchmark frame statistics for 8-bit types and several sampling grids" },
+        { wxCMD_LINE_OPTION, nullptr, "decode", "video file to decode with each backend and number of decoder threads" },
+        { wxCMD_LINE_SWITCH, nullptr, "paint", "benchmark drawing a converted wxBitmap and cairo surface (needs wxGTK3 and GUI)" },
+        wxCMD_LINE_DESC_END
+    };
+
+    wxCmdLineParser parser(cmdLineDesc, argc, argv);
+
+    if ( parser.Parse() != 0 )
+        return 1;
+
+    const bool       useBitmaps = parser.Found("bitmap");
+
+    if ( parser.Found("verify") )
+        return VerifyConversions(useBitmaps) == 0 ? 0 : 1;
+
+    wxArrayString    selectedResolutions, selectedTypes, selectedPaths;
+    wxArrayString    threadCountStrings;
+    std::vector<int> threadCounts;
+    long             minTimeMs = 200;
+    long             tolerancePercent = 20;
+    wxString         str, outputFileName, baselineFileName;
+    std::map<wxString, double> baseline, results; // case key -> nsPerPixel
+
+    if ( parser.Found("resolutions", &str) )
+        selectedResolutions = wxSplit(str, ',');
+    if ( parser.Found("types", &str) )
+        selectedTypes = wxSplit(str, ',');
+    if ( parser.Found("paths", &str) )
+        selectedPaths = wxSplit(str, ',');
+
+    if ( !parser.Found("threads", &str) )
+        str = "1,2,4";
+    threadCountStrings = wxSplit(str, ',');
+    for ( const auto& s : threadCountStrings )
+    {
+        long threadCount = 0;
+
+        if ( !s.ToLong(&threadCount) || threadCount < 1 )
+        {
+            fprintf(stderr, "Invalid number of threads '%s'.\n", static_cast<const char*>(s.utf8_str()));
+            return 1;
+        }
+        threadCounts.push_back(static_cast<int>(threadCount));
+    }
+
+    parser.Found("min-time", &minTimeMs);
+    parser.Found("output", &outputFileName);
+    parser.Found("tolerance", &tolerancePercent);
+
+    if ( parser.Found("export") )
+    {
+        wxString videoFileName;
+        long     frameCount = 200;
+
+        parser.Found("video", &videoFileName);
+        parser.Found("frames", &frameCount);
+
+        if ( frameCount < 1 )
+        {
+            fprintf(stderr, "Invalid number of frames.\n");
+            return 1;
+        }
+
+        BenchJSONWriter jsonWriter;
+
+        if ( BenchmarkVideoExport(videoFileName, static_cast<int>(frameCount), threadCounts, jsonWriter) != 0 )
+            return 1;
+
+        return jsonWriter.Write(outputFileName) ? 0 : 1;
+    }
+
+    wxString decodeFileName;
+
+    if ( parser.Found("decode", &decodeFileName) )
+    {
+        std::vector<int> decodeThreadCounts = { VideoCaptureOptions::Default };
+        long             frameCount = 0;
+
+        parser.Found("frames", &frameCount);
+
+#if VIDEOCAPTURE_HAS_THREAD_COUNT
+        // 0 means all CPU cores
+        if ( parser.Found("threads") )
+            decodeThreadCounts.insert(decodeThreadCounts.end(), threadCounts.begin(), threadCounts.end());
+        else
+            decodeThreadCounts.insert(decodeThreadCounts.end(), { 1, 2, 4, 0 });
+#else
+        fprintf(stderr, "This OpenCV version does not support setting the number of decoder threads.\n");
+#endif
+
+        if ( frameCount < 0 )
+        {
+            fprintf(stderr, "Invalid number of frames.\n");
+            return 1;
+        }
+
+        BenchJSONWriter jsonWriter;
+
+        if ( BenchmarkVideoDecode(decodeFileName, frameCount, decodeThreadCounts, jsonWriter) != 0 )
+            return 1;
+
+        return jsonWriter.Write(outputFileName) ? 0 : 1;
+    }
+
+    if ( parser.Found("paint") )
+    {
+        BenchJSONWriter jsonWriter;
+
+        if ( BenchmarkPaint(selectedResolutions, selectedTypes, minTimeMs, jsonWriter) != 0 )
+            return 1;
+
+        return jsonWriter.Write(outputFileName) ? 0 : 1;
+    }
+
+    if ( parser.Found("stats") )
+    {
+        BenchJSONWriter jsonWriter;
+
+        if ( BenchmarkFrameStatistics(selectedResolutions, selectedTypes, minTimeMs, jsonWriter) != 0 )
+            return 1;
+
+        return jsonWriter.Write(outputFileName) ? 0 : 1;
+    }
+
+    if ( parser.Found("ring") )
+    {
+        BenchJSONWriter jsonWriter;
+
+        if ( BenchmarkSharedFrameRing(minTimeMs, jsonWriter) != 0 )
+            return 1;
+
+        return jsonWriter.Write(outputFileName) ? 0 : 1;
+    }
+
+    wxString imageFileName;
+
+    if ( parser.Found("load", &imageFileName) )
+    {
+        wxString rawLayout;
+
+        parser.Found("layout", &rawLayout);
+
+        BenchJSONWriter jsonWriter;
+
+        if ( BenchmarkImageLoad(imageFileName, rawLayout, minTimeMs, jsonWriter) != 0 )
+            return 1;
+
+        return jsonWriter.Write(outputFileName) ? 0 : 1;
+    }
+
+    if ( parser.Found("baseline", &baselineFileName) )
+    {
+        // Times measured in unoptimized builds are many times longer
+        // and vary too much to be compared with anything.
+        const wxString buildType(OCVBENCH_BUILD_TYPE);
+        wxString       baselineBuildType;
+
+        if ( buildType != "Release" )
+        {
+            fprintf(stderr, "Results are compared with a baseline only in Release builds, this is '%s' build.\n",
+                    static_cast<const char*>(buildType.utf8_str()));
+            return SkipExitCode;
+        }
+
+        if ( !wxFileExists(baselineFileName) )
+        {
+            fprintf(stderr, "There is no baseline '%s' yet, create it by running the program with --output.\n",
+                    static_cast<const char*>(baselineFileName.utf8_str()));
+            return SkipExitCode;
+        }
+
+        if ( !ReadBaseline(baselineFileName, baseline, baselineBuildType) )
+        {
+            fprintf(stderr, "Could not read baseline results from '%s'.\n",
+                    static_cast<const char*>(baselineFileName.utf8_str()));
+            return 1;
+        }
+
+        if ( baselineBuildType != buildType )
+        {
+            fprintf(stderr, "Baseline '%s' was measured in '%s' build, this is '%s' build.\n",
+                    static_cast<const char*>(baselineFileName.utf8_str()),
+                    static_cast<const char*>(baselineBuildType.utf8_str()),
+                    static_cast<const char*>(buildType.utf8_str()));
+            return SkipExitCode;
+        }
+    }
+
+    BenchJSONWriter jsonWriter;
+
+    jsonWriter.AddRawField("hardwareThreads", wxString::Format("%u", std::thread::hardware_concurrency()));
+
+    for ( const auto& resolution : Resolutions )
+    {
+        if ( !IsNameSelected(selectedResolutions, resolution.name) )
+            continue;
+
+        for ( const int type : MatTypes )
+        {
+            const wxString typeName(cv::typeToString(type));
+
+            if ( !IsNameSelected(selectedTypes, typeName) )
+                continue;
+
+            for ( const bool roi : { false, true } )
+            {
+                const cv::Mat matBitmap = CreateSourceMat(resolution.width, resolution.height, type, roi);
+
+                for ( const auto& path : ConversionPaths )
+                {
+                    if ( (path.needsGUI && !useBitmaps)
+                         || !IsNameSelected(selectedPaths, path.name)
+                         || !path.supportsType(type) )
+                    {
+                        continue;
+                    }
+
+                    // ROI makes no difference for paths converting to Mat
+                    if ( roi && path.convertsToMat )
+                        continue;
+
+                    for ( const int threadCount : threadCounts )
+                    {
+                        if ( path.needsGUI && threadCount != 1 )
+                            continue;
+
+                        CaseResult result;
+
+                        fprintf(stderr, "%s %s %s%s, %d thread(s)...\n", path.name, resolution.name,
+                                static_cast<const char*>(typeName.utf8_str()), roi ? " ROI" : "", threadCount);
+
+                        if ( !RunCase(path, matBitmap, threadCount, minTimeMs, result) )
+                        {
+                            fprintf(stderr, "Conversion failed.\n");
+                            return 1;
+                        }
+
+                        wxString fields;
+
+                        fields << wxString::Format("\"path\": \"%s\", ", path.name);
+                        fields << wxString::Format("\"resolution\": \"%s\", \"width\": %d, \"height\": %d, ",
+                                                   resolution.name, resolution.width, resolution.height);
+                        fields << wxString::Format("\"type\": \"%s\", \"roi\": %s, \"threads\": %d, ",
+                                                   typeName, roi ? "true" : "false", threadCount);
+                        fields << wxString::Format("\"iterations\": %lu, \"meanMs\": %.4f, \"minMs\": %.4f, ",
+                                                   static_cast<unsigned long>(result.iterations), result.meanMs, result.minMs);
+                        fields << wxString::Format("\"stdDevMs\": %.4f, \"varianceMs2\": %.6f, ",
+                                                   std::sqrt(result.varianceMs2), result.varianceMs2);
+                        fields << wxString::Format("\"nsPerPixel\": %.4f, \"GBPerSec\": %.4f",
+                                                   result.nsPerPixel, result.gbPerSec);
+                        jsonWriter.AddResult(fields);
+
+                        results[GetCaseKey(path.name, resolution.name, typeName, roi, threadCount)] = result.nsPerPixel;
+                    }
+                }
+            }
+        }
+    }
+
+    if ( !jsonWriter.Write(outputFileName) )
+        return 1;
+
+    int regressionCount = 0;
+
+    for ( const auto& result : results )
+    {
+        const auto it = baseline.find(result.first);
+
+        if ( it == baseline.end() )
+            continue;
+
+        if ( result.second > it->second * (1. + tolerancePercent / 100.) )
+        {
+            ++regressionCount;
+            fprintf(stderr, "REGRESSION: %s: %.4f ns/pixel, baseline %.4f ns/pixel\n",
+                    static_cast<const char*>(result.first.utf8_str()), result.second, it->second);
+        }
+    }
+
+    if ( !baseline.empty() )
+        fprintf(stderr, "%d case(s) slower than baseline.\n", regressionCount);
+
+    return regressionCount == 0 ? 0 : 2;
+}
@@ -0,0 +1,132 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        ocvbench.h
+// Purpose:     Shared parts of the wxTestOpenCV benchmark program
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef OCVBENCH_H
+#define OCVBENCH_H
+
+#include <cstddef>
+#include <vector>
+
+#include <wx/arrstr.h>
+#include <wx/string.h>
+
+#include <opencv2/core.hpp>
+
+// CMake sets it to the configuration the program is built in
+// (e.g., Release), it is written to the results and the times
+// are compared only between results from the same configuration.
+#ifndef OCVBENCH_BUILD_TYPE
+    #define OCVBENCH_BUILD_TYPE ""
+#endif
+
+struct Resolution
+{
+    const char* name;
+    int         width;
+    int         height;
+};
+
+const Resolution Resolutions[] =
+{
+    { "VGA",   640,  480 },
+    { "HD",   1280,  720 },
+    { "FHD",  1920, 1080 },
+    { "4K",   3840, 2160 },
+    { "8K",   7680, 4320 },
+};
+
+const int MatTypes[] = { CV_8UC1, CV_8UC3, CV_8UC4, CV_16UC1, CV_16UC3, CV_32FC1, CV_32FC3 };
+
+// Minimum number of measured iterations per case and thread.
+const size_t MinIterations = 5;
+
+// Returns Mat of given size and type filled with random values.
+// If roi is true, the Mat is not continuous: it is a part of a wider Mat.
+cv::Mat CreateSourceMat(int width, int height, int type, bool roi);
+
+// Returns true if selected is empty or contains name.
+bool IsNameSelected(const wxArrayString& selected, const wxString& name);
+
+// Collects the results of a benchmark and formats them as JSON:
+// an object with fields describing the benchmark and an array
+// of results. Each result is written on a single line, so that
+// the JSON can be read back line by line, see ReadBaseline().
+class BenchJSONWriter
+{
+public:
+    // Adds the wxWidgets and OpenCV versions and the build type.
+    BenchJSONWriter();
+
+    // Adds a field describing the benchmark with a string value.
+    void AddField(const wxString& name, const wxString& value);
+    // Adds a field describing the benchmark with value
+    // already formatted as JSON, e.g., a number.
+    void AddRawField(const wxString& name, const wxString& value);
+
+    // Adds a result, its fields must be already formatted as JSON,
+    // e.g., "\"threads\": 2, \"fps\": 30.50".
+    void AddResult(const wxString& fields);
+
+    wxString GetJSON() const;
+
+    // Writes the JSON to fileName or to the standard output if fileName is empty.
+    bool Write(const wxString& fileName) const;
+
+    // Returns value as a JSON string, i.e., quoted and escaped.
+    static wxString Quote(const wxString& value);
+
+private:
+    std::vector<wxString> m_fields;
+    std::vector<wxString> m_results;
+};
+
+//
+// The benchmark modes, each returns 0 on success.
+//
+
+// Exports frameCount frames of videoFileName (of a generated video
+// if it is empty) with each number of workers in threadCounts.
+// See ocvbenchexport.cpp.
+int BenchmarkVideoExport(wxString videoFileName, int frameCount,
+                         const std::vector<int>& threadCounts, BenchJSONWriter& jsonWriter);
+
+// Loads fileName and converts it to wxImage, either memory-mapped or with
+// cv::imread(), repeatedly for at least minTimeMs. rawLayout is used
+// for files with the .raw extension, see RawImageLayout.
+// See ocvbenchload.cpp.
+int BenchmarkImageLoad(const wxString& fileName, const wxString& rawLayout,
+                       long minTimeMs, BenchJSONWriter& jsonWriter);
+
+// Runs a producer writing FHD frames into a shared-memory frame ring as fast
+// as it can and a consumer converting the newest frames to wxImage,
+// for at least minTimeMs with each SharedFrameRingProducer::FullPolicy.
+// See ocvbenchring.cpp.
+int BenchmarkSharedFrameRing(long minTimeMs, BenchJSONWriter& jsonWriter);
+
+// Computes the statistics of frames of the selected resolutions and 8-bit types
+// with several sampling grids, for at least minTimeMs each, and checks
+// the histograms against cv::calcHist(). See ocvbenchstats.cpp.
+int BenchmarkFrameStatistics(const wxArrayString& selectedResolutions, const wxArrayString& selectedTypes,
+                             long minTimeMs, BenchJSONWriter& jsonWriter);
+
+// Measures converting a frame and drawing it on a cairo-based wxMemoryDC
+// the way wxBitmapFromOpenCVPanel paints it: once converted into a wxBitmap
+// and once converted directly into a cairo image surface, for at least
+// minTimeMs each. FHD and 4K by default. Needs wxGTK3 and GUI.
+// See ocvbenchpaint.cpp.
+int BenchmarkPaint(const wxArrayString& selectedResolutions, const wxArrayString& selectedTypes,
+                   long minTimeMs, BenchJSONWriter& jsonWriter);
+
+// Decodes at most maxFrameCount frames (all if 0) of videoFileName with each available
+// backend and each number of decoder threads in threadCounts (VideoCaptureOptions::Default
+// means the backend default). See ocvbenchdecode.cpp.
+int BenchmarkVideoDecode(const wxString& videoFileName, long maxFrameCount,
+                         const std::vector<int>& threadCounts, BenchJSONWriter& jsonWriter);
+
+#endif // #ifndef OCVBENCH_H
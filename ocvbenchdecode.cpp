@@ -0,0 +1,138 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        ocvbenchdecode.cpp
+// Purpose:     Video decoding benchmark of the wxTestOpenCV benchmark program
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <wx/wx.h>
+#include <wx/filename.h>
+
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#ifdef __WINDOWS__
+    #include <wx/msw/wrapwin.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+#include "ocvbench.h"
+#include "videocaptureoptions.h"
+
+namespace
+{
+
+// Returns the CPU time (user and kernel) the process has used, in ms.
+double GetProcessCPUTimeMs()
+{
+#ifdef __WINDOWS__
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+
+    if ( !::GetProcessTimes(::GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime) )
+        return 0.;
+
+    // in 100 ns units
+    const ULONGLONG kernel = (static_cast<ULONGLONG>(kernelTime.dwHighDateTime) << 32) | kernelTime.dwLowDateTime;
+    const ULONGLONG user = (static_cast<ULONGLONG>(userTime.dwHighDateTime) << 32) | userTime.dwLowDateTime;
+
+    return (kernel + user) / 10000.;
+#else
+    struct rusage usage;
+
+    if ( getrusage(RUSAGE_SELF, &usage) != 0 )
+        return 0.;
+
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.
+           + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.;
+#endif
+}
+
+} // unnamed namespace
+
+int BenchmarkVideoDecode(const wxString& videoFileName, long maxFrameCount,
+                         const std::vector<int>& threadCounts, BenchJSONWriter& jsonWriter)
+{
+    if ( !wxFileExists(videoFileName) )
+    {
+        fprintf(stderr, "Video file '%s' does not exist.\n", static_cast<const char*>(videoFileName.utf8_str()));
+        return 1;
+    }
+
+    jsonWriter.AddRawField("hardwareThreads", wxString::Format("%u", std::thread::hardware_concurrency()));
+    jsonWriter.AddField("file", wxFileName(videoFileName).GetFullName());
+
+    for ( const int backend : GetAvailableVideoCaptureBackends(false) )
+    {
+        const wxString backendName = GetVideoCaptureBackendName(backend);
+
+        for ( const int threadCount : threadCounts )
+        {
+            VideoCaptureOptions options;
+            cv::VideoCapture    capture;
+            cv::Mat             frame;
+            bool                opened = false;
+            long                frameCount = 0;
+
+            options.backend = backend;
+            options.threadCount = threadCount;
+
+            fprintf(stderr, "Decoding with %s...\n", static_cast<const char*>(options.ToString().utf8_str()));
+
+            const double cpuStartMs = GetProcessCPUTimeMs();
+            wxStopWatch  stopWatch;
+
+            // Not all backends can open all files or support
+            // the options, that is a result too.
+            try
+            {
+                opened = OpenVideoCapture(capture, videoFileName, options);
+
+                while ( opened && (maxFrameCount == 0 || frameCount < maxFrameCount) && capture.read(frame) )
+                    ++frameCount;
+            }
+            catch ( const std::exception& e )
+            {
+                fprintf(stderr, "%s\n", e.what());
+                opened = false;
+            }
+
+            const double elapsedMs = stopWatch.TimeInMicro().ToDouble() / 1000.;
+            const double cpuMs = GetProcessCPUTimeMs() - cpuStartMs;
+
+            wxString fields;
+
+            fields << wxString::Format("\"backend\": \"%s\", ", backendName);
+            if ( threadCount == VideoCaptureOptions::Default )
+                fields << "\"threads\": \"default\", ";
+            else
+                fields << wxString::Format("\"threads\": %d, ", threadCount);
+
+            if ( !opened )
+            {
+                fields << "\"opened\": false";
+                jsonWriter.AddResult(fields);
+                continue;
+            }
+
+            const wxArrayString reportedOptions = GetVideoCaptureReportedOptions(capture);
+
+            fields << wxString::Format("\"opened\": true, \"reported\": %s, ",
+                                       BenchJSONWriter::Quote(wxJoin(reportedOptions, ',')));
+            fields << wxString::Format("\"frames\": %ld, \"elapsedMs\": %.1f, \"fps\": %.2f, ",
+                                       frameCount, elapsedMs, elapsedMs > 0. ? frameCount * 1000. / elapsedMs : 0.);
+            // cpuUtilization is the average number of CPU cores busy
+            fields << wxString::Format("\"cpuMs\": %.1f, \"cpuMsPerFrame\": %.3f, \"cpuUtilization\": %.2f",
+                                       cpuMs, frameCount ? cpuMs / frameCount : 0., elapsedMs > 0. ? cpuMs / elapsedMs : 0.);
+            jsonWriter.AddResult(fields);
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,143 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        ocvbenchexport.cpp
+// Purpose:     Video export benchmark of the wxTestOpenCV benchmark program
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <wx/wx.h>
+#include <wx/filename.h>
+
+#include <thread>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+
+#include "ocvbench.h"
+#include "videoexport.h"
+
+namespace
+{
+
+// Writes a video with a moving pattern and noise,
+// so that the encoder cannot compress it too easily.
+bool CreateTestVideo(const wxString& fileName, int frameCount)
+{
+    const cv::Size  size(1280, 720);
+    cv::VideoWriter writer(fileName.ToStdString(), cv::VideoWriter::fourcc('M', 'J', 'P', 'G'), 25., size);
+    cv::Mat         frame(size, CV_8UC3), noise(size, CV_8UC3);
+
+    if ( !writer.isOpened() )
+        return false;
+
+    for ( int i = 0; i < frameCount; ++i )
+    {
+        frame.setTo(cv::Scalar(64, 128, 192));
+        cv::circle(frame, cv::Point((i * 16) % size.width, size.height / 2), 120, cv::Scalar(255, 255, 255), cv::FILLED);
+        cv::randu(noise, 0, 32);
+        frame += noise;
+        writer.write(frame);
+    }
+
+    return true;
+}
+
+} // unnamed namespace
+
+int BenchmarkVideoExport(wxString videoFileName, int frameCount,
+                         const std::vector<int>& threadCounts, BenchJSONWriter& jsonWriter)
+{
+    const wxString tempFileName = wxFileName::CreateTempFileName("ocvbench");
+    const wxString outputFileName = tempFileName + "-export.avi";
+    bool           removeVideo = false;
+
+    if ( tempFileName.empty() )
+    {
+        fprintf(stderr, "Could not create a temporary file.\n");
+        return 1;
+    }
+
+    if ( videoFileName.empty() )
+    {
+        videoFileName = tempFileName + "-input.avi";
+        fprintf(stderr, "Creating test video '%s'...\n", static_cast<const char*>(videoFileName.utf8_str()));
+        if ( !CreateTestVideo(videoFileName, frameCount) )
+        {
+            fprintf(stderr, "Could not create test video.\n");
+            wxRemoveFile(tempFileName);
+            return 1;
+        }
+        removeVideo = true;
+    }
+
+    // Heavy enough per-frame processing to dominate
+    // decoding and encoding, which cannot run in parallel.
+    const FrameProcessingStage stage = { "Denoise (bilateral)", [](const cv::Mat& in)
+        {
+            cv::Mat out;
+
+            cv::bilateralFilter(in, out, 9, 50., 50.);
+            return out;
+        }
+    };
+
+    double singleWorkerFps = 0.;
+    int    result = 0;
+
+    jsonWriter.AddRawField("hardwareThreads", wxString::Format("%u", std::thread::hardware_concurrency()));
+    jsonWriter.AddField("stage", stage.name);
+
+    for ( const int threadCount : threadCounts )
+    {
+        VideoExportOptions options;
+        wxString           errorMessage;
+
+        options.inputFileName = videoFileName;
+        options.outputFileName = outputFileName;
+        options.lastFrame = frameCount - 1;
+        options.workerCount = threadCount;
+        options.stages.push_back(stage);
+
+        fprintf(stderr, "Export, %d worker(s)...\n", threadCount);
+
+        VideoExportJob job(options, nullptr);
+
+        if ( !job.Start(errorMessage) )
+        {
+            fprintf(stderr, "%s\n", static_cast<const char*>(errorMessage.utf8_str()));
+            result = 1;
+            break;
+        }
+
+        job.Wait();
+
+        const VideoExportProgress progress = job.GetProgress();
+
+        if ( !progress.errorMessage.empty() )
+        {
+            fprintf(stderr, "%s\n", static_cast<const char*>(progress.errorMessage.utf8_str()));
+            result = 1;
+            break;
+        }
+
+        if ( singleWorkerFps == 0. )
+            singleWorkerFps = progress.fps;
+
+        jsonWriter.AddResult(wxString::Format("\"workers\": %d, \"frames\": %d, \"elapsedMs\": %.1f, ",
+                                              threadCount, progress.framesWritten, progress.elapsedMs)
+                             + wxString::Format("\"fps\": %.2f, \"MBPerSec\": %.2f, \"speedup\": %.2f",
+                                                progress.fps, progress.MBPerSec,
+                                                singleWorkerFps > 0. ? progress.fps / singleWorkerFps : 0.));
+    }
+
+    wxRemoveFile(outputFileName);
+    wxRemoveFile(tempFileName);
+    if ( removeVideo )
+        wxRemoveFile(videoFileName);
+
+    return result;
+}
@@ -0,0 +1,164 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        ocvbenchload.cpp
+// Purpose:     Image load benchmark of the wxTestOpenCV benchmark program
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <wx/wx.h>
+#include <wx/filename.h>
+
+#include <algorithm>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#ifdef __WINDOWS__
+    #include <wx/msw/wrapwin.h>
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+#include "convertmattowxbmp.h"
+#include "mappedimage.h"
+#include "ocvbench.h"
+
+namespace
+{
+
+// Returns the peak resident set size (working set on MSW) of the process in MB.
+double GetPeakRSSMB()
+{
+#ifdef __WINDOWS__
+    PROCESS_MEMORY_COUNTERS counters;
+
+    if ( !::GetProcessMemoryInfo(::GetCurrentProcess(), &counters, sizeof(counters)) )
+        return 0.;
+    return counters.PeakWorkingSetSize / (1024. * 1024.);
+#else
+    struct rusage usage;
+
+    if ( getrusage(RUSAGE_SELF, &usage) != 0 )
+        return 0.;
+#ifdef __APPLE__
+    return usage.ru_maxrss / (1024. * 1024.); // in bytes
+#else
+    return usage.ru_maxrss / 1024.;           // in kilobytes
+#endif
+#endif
+}
+
+} // unnamed namespace
+
+int BenchmarkImageLoad(const wxString& fileName, const wxString& rawLayout,
+                       long minTimeMs, BenchJSONWriter& jsonWriter)
+{
+    const bool     isRaw = wxFileName(fileName).GetExt().IsSameAs("raw", false);
+    RawImageLayout layout;
+    wxImage        image;
+    wxString       errorMessage;
+
+    if ( isRaw && !layout.Parse(rawLayout) )
+    {
+        fprintf(stderr, "Invalid or missing --layout for raw image '%s'.\n",
+                static_cast<const char*>(fileName.utf8_str()));
+        return 1;
+    }
+
+    // both methods convert into the same image, allocated only once
+    auto load = [&](bool mapped, double& loadMs, double& convertMs) -> bool
+    {
+        MappedImage mappedImage;
+        cv::Mat     matBitmap;
+        wxStopWatch stopWatch;
+
+        stopWatch.Start();
+        if ( mapped )
+        {
+            if ( !(isRaw ? mappedImage.OpenRaw(fileName, layout, errorMessage)
+                         : mappedImage.Open(fileName, errorMessage)) )
+            {
+                return false;
+            }
+        }
+        else
+        {
+            matBitmap = cv::imread(fileName.ToStdString(), cv::IMREAD_UNCHANGED);
+            if ( matBitmap.empty() )
+            {
+                errorMessage = "cv::imread() failed.";
+                return false;
+            }
+        }
+        loadMs = stopWatch.TimeInMicro().ToDouble() / 1000.;
+
+        const cv::Mat&                    source = mapped ? mappedImage.GetMat() : matBitmap;
+        const MatBitmapConversionOptions& options = mappedImage.GetConversionOptions();
+
+        if ( !image.IsOk() || image.GetWidth() != source.cols || image.GetHeight() != source.rows )
+            image.Create(source.cols, source.rows, false);
+
+        stopWatch.Start();
+        if ( !ConvertMatBitmapTowxImage(source, image, options) )
+        {
+            errorMessage = "Conversion failed.";
+            return false;
+        }
+        convertMs = stopWatch.TimeInMicro().ToDouble() / 1000.;
+
+        return true;
+    };
+
+    jsonWriter.AddField("file", wxFileName(fileName).GetFullName());
+    jsonWriter.AddRawField("fileSizeMB", wxString::Format("%.1f", wxFileName(fileName).GetSize().ToDouble() / (1024. * 1024.)));
+
+    // The peak RSS only grows, so the method expected to need less memory runs first
+    // and the increase of the peak is reported for each method.
+    for ( const bool mapped : { true, false } )
+    {
+        const char*  method = mapped ? "mapped" : "imread";
+        const double peakBefore = GetPeakRSSMB();
+        double       loadMs = 0., convertMs = 0.;
+
+        fprintf(stderr, "Loading %s...\n", method);
+
+        // the first load warms up the file cache and is not measured
+        if ( !load(mapped, loadMs, convertMs) )
+        {
+            fprintf(stderr, "Could not load '%s' %s: %s\n", static_cast<const char*>(fileName.utf8_str()),
+                    method, static_cast<const char*>(errorMessage.utf8_str()));
+            return 1;
+        }
+
+        double      sumLoadMs = 0., sumConvertMs = 0., minTotalMs = 0.;
+        size_t      count = 0;
+        wxStopWatch totalStopWatch;
+
+        do
+        {
+            if ( !load(mapped, loadMs, convertMs) )
+                return 1;
+            sumLoadMs += loadMs;
+            sumConvertMs += convertMs;
+            minTotalMs = count == 0 ? loadMs + convertMs : std::min(minTotalMs, loadMs + convertMs);
+            ++count;
+        } while ( totalStopWatch.Time() < minTimeMs || count < MinIterations );
+
+        const double peakAfter = GetPeakRSSMB();
+
+        wxString fields;
+
+        fields << wxString::Format("\"method\": \"%s\", \"iterations\": %lu, ",
+                                   method, static_cast<unsigned long>(count));
+        fields << wxString::Format("\"meanLoadMs\": %.3f, \"meanConvertMs\": %.3f, \"minTotalMs\": %.3f, ",
+                                   sumLoadMs / count, sumConvertMs / count, minTotalMs);
+        fields << wxString::Format("\"peakRSSMB\": %.1f, \"peakRSSIncreaseMB\": %.1f",
+                                   peakAfter, peakAfter - peakBefore);
+        jsonWriter.AddResult(fields);
+    }
+
+    return 0;
+}
@@ -0,0 +1,199 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        ocvbenchpaint.cpp
+// Purpose:     Paint benchmark of the wxTestOpenCV benchmark program
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <wx/wx.h>
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include <opencv2/core.hpp>
+
+#ifdef __WXGTK3__
+    #include <wx/dcmemory.h>
+    #include <wx/graphics.h>
+
+    #include <cairo.h>
+#endif
+
+#include "convertmattowxbmp.h"
+#include "ocvbench.h"
+
+#ifdef __WXGTK3__
+
+namespace
+{
+
+struct PaintResult
+{
+    size_t iterations{0};
+    double meanConvertMs{0.};
+    double meanDrawMs{0.};
+    double minTotalMs{0.};
+};
+
+// Calls convert and then draw, as the panel does for every new frame, at least
+// MinIterations times and for at least minTimeMs, and measures both separately.
+void RunPaintCase(const std::function<void()>& convert, const std::function<void()>& draw,
+                  long minTimeMs, PaintResult& result)
+{
+    double      sumConvertMs = 0., sumDrawMs = 0.;
+    size_t      count = 0;
+    wxStopWatch totalStopWatch, stopWatch;
+
+    // warm up, e.g., the first draw may allocate
+    convert();
+    draw();
+
+    totalStopWatch.Start();
+    do
+    {
+        stopWatch.Start();
+        convert();
+
+        const double convertMs = stopWatch.TimeInMicro().ToDouble() / 1000.;
+
+        stopWatch.Start();
+        draw();
+
+        const double drawMs = stopWatch.TimeInMicro().ToDouble() / 1000.;
+
+        sumConvertMs += convertMs;
+        sumDrawMs += drawMs;
+        result.minTotalMs = count == 0 ? convertMs + drawMs : std::min(result.minTotalMs, convertMs + drawMs);
+        ++count;
+    } while ( totalStopWatch.Time() < minTimeMs || count < MinIterations );
+
+    result.iterations = count;
+    result.meanConvertMs = sumConvertMs / count;
+    result.meanDrawMs = sumDrawMs / count;
+}
+
+} // unnamed namespace
+
+#endif // #ifdef __WXGTK3__
+
+// wxBitmap is stored as GdkPixbuf, which wxGTK3 must convert
+// to a cairo surface when drawing it.
+int BenchmarkPaint(const wxArrayString& selectedResolutions, const wxArrayString& selectedTypes,
+                   long minTimeMs, BenchJSONWriter& jsonWriter)
+{
+#ifdef __WXGTK3__
+    jsonWriter.AddField("cairo", cairo_version_string());
+
+    for ( const auto& resolution : Resolutions )
+    {
+        if ( selectedResolutions.empty() )
+        {
+            if ( strcmp(resolution.name, "FHD") != 0 && strcmp(resolution.name, "4K") != 0 )
+                continue;
+        }
+        else if ( !IsNameSelected(selectedResolutions, resolution.name) )
+        {
+            continue;
+        }
+
+        for ( const int type : { CV_8UC3, CV_8UC4 } )
+        {
+            const wxString typeName(cv::typeToString(type));
+
+            if ( !IsNameSelected(selectedTypes, typeName) )
+                continue;
+
+            const cv::Mat matBitmap = CreateSourceMat(resolution.width, resolution.height, type, false);
+            const int     depth = GetwxBitmapDepthForMatBitmap(matBitmap);
+            wxBitmap      target(resolution.width, resolution.height, 24);
+            wxMemoryDC    dc(target);
+            wxBitmap      bitmap(resolution.width, resolution.height, depth);
+
+            wxGraphicsContext* gc = dc.GetGraphicsContext();
+
+            if ( !gc )
+            {
+                fprintf(stderr, "wxMemoryDC has no graphics context.\n");
+                return 1;
+            }
+
+            std::shared_ptr<cairo_surface_t> surface(
+                cairo_image_surface_create(depth == 32 ? CAIRO_FORMAT_ARGB32 : CAIRO_FORMAT_RGB24,
+                                           resolution.width, resolution.height),
+                cairo_surface_destroy);
+
+            if ( cairo_surface_status(surface.get()) != CAIRO_STATUS_SUCCESS )
+            {
+                fprintf(stderr, "Could not create cairo surface.\n");
+                return 1;
+            }
+
+            bool        failed = false;
+            PaintResult bitmapResult, surfaceResult;
+
+            fprintf(stderr, "Paint %s %s...\n", resolution.name, static_cast<const char*>(typeName.utf8_str()));
+
+            RunPaintCase(
+                [&]() { failed = !ConvertMatBitmapTowxBitmap(matBitmap, bitmap) || failed; },
+                [&]()
+                {
+                    dc.DrawBitmap(bitmap, 0, 0, false);
+                    gc->Flush();
+                },
+                minTimeMs, bitmapResult);
+
+            RunPaintCase(
+                [&]() { failed = !ConvertMatBitmapToCairoSurface(matBitmap, surface.get()) || failed; },
+                [&]()
+                {
+                    // as in wxBitmapFromOpenCVPanel::OnPaint(), wxGraphicsBitmap
+                    // takes ownership of the surface
+                    cairo_surface_reference(surface.get());
+
+                    const wxGraphicsBitmap gcBitmap = gc->GetRenderer()->CreateBitmapFromNativeBitmap(surface.get());
+
+                    gc->DrawBitmap(gcBitmap, 0, 0, resolution.width, resolution.height);
+                    gc->Flush();
+                },
+                minTimeMs, surfaceResult);
+
+            if ( failed )
+            {
+                fprintf(stderr, "Conversion failed.\n");
+                return 1;
+            }
+
+            for ( const auto& result : { std::make_pair("wxBitmap", bitmapResult),
+                                         std::make_pair("cairoSurface", surfaceResult) } )
+            {
+                wxString fields;
+
+                fields << wxString::Format("\"method\": \"%s\", \"resolution\": \"%s\", \"type\": \"%s\", ",
+                                           result.first, resolution.name, typeName);
+                fields << wxString::Format("\"iterations\": %lu, \"meanConvertMs\": %.3f, \"meanDrawMs\": %.3f, ",
+                                           static_cast<unsigned long>(result.second.iterations),
+                                           result.second.meanConvertMs, result.second.meanDrawMs);
+                fields << wxString::Format("\"meanTotalMs\": %.3f, \"minTotalMs\": %.3f",
+                                           result.second.meanConvertMs + result.second.meanDrawMs,
+                                           result.second.minTotalMs);
+                jsonWriter.AddResult(fields);
+            }
+        }
+    }
+
+    return 0;
+#else
+    wxUnusedVar(selectedResolutions);
+    wxUnusedVar(selectedTypes);
+    wxUnusedVar(minTimeMs);
+    wxUnusedVar(jsonWriter);
+
+    fprintf(stderr, "Painting cairo surfaces is available only with wxGTK3.\n");
+    return 1;
+#endif // #ifdef __WXGTK3__
+}
@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        ocvbenchring.cpp
+// Purpose:     Frame ring benchmark of the wxTestOpenCV benchmark program
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <wx/wx.h>
+
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core.hpp>
+
+#include "convertmattowxbmp.h"
+#include "ocvbench.h"
+#include "sharedframering.h"
+
+// The producer and consumer run in threads of this process,
+// but they still communicate only through the shared memory.
+int BenchmarkSharedFrameRing(long minTimeMs, BenchJSONWriter& jsonWriter)
+{
+    typedef SharedFrameRingProducer::FullPolicy FullPolicy;
+
+    const size_t                 slotCount = 4;
+    const std::string            ringName = wxString::Format("ocvbench%lu", wxGetProcessId()).ToStdString();
+    const cv::Mat                source = CreateSourceMat(1920, 1080, CV_8UC3, false);
+    const double                 frameMB = source.total() * source.elemSize() / (1024. * 1024.);
+    SharedFrameRingFormat        format;
+
+    format.width = source.cols;
+    format.height = source.rows;
+    format.type = source.type();
+
+    jsonWriter.AddRawField("width", wxString::Format("%d", format.width));
+    jsonWriter.AddRawField("height", wxString::Format("%d", format.height));
+    jsonWriter.AddField("type", wxString(cv::typeToString(format.type)));
+    jsonWriter.AddRawField("slots", wxString::Format("%lu", static_cast<unsigned long>(slotCount)));
+
+    for ( const FullPolicy policy : { SharedFrameRingProducer::OverwriteOldest, SharedFrameRingProducer::WaitForConsumer } )
+    {
+        const char*             policyName = policy == SharedFrameRingProducer::OverwriteOldest
+                                             ? "overwriteOldest" : "waitForConsumer";
+        SharedFrameRingProducer producer;
+        SharedFrameRingConsumer consumer;
+        std::string             errorMessage;
+
+        fprintf(stderr, "Shared-memory ring, %s...\n", policyName);
+
+        if ( !producer.Create(ringName, format, slotCount, policy, errorMessage)
+             || !consumer.Open(ringName, errorMessage) )
+        {
+            fprintf(stderr, "Could not create frame ring: %s\n", errorMessage.c_str());
+            return 1;
+        }
+
+        std::atomic<bool> stop{false};
+        std::thread       producerThread([&]
+            {
+                while ( !stop )
+                    producer.Write(source.data, source.step, 100);
+                producer.Close();
+            });
+
+        wxImage             image(format.width, format.height, false);
+        std::vector<double> latenciesUs; // from publishing to the end of the conversion
+        wxStopWatch         stopWatch;
+        bool                converted = true;
+
+        while ( stopWatch.Time() < minTimeMs || latenciesUs.size() < MinIterations )
+        {
+            SharedFrameRingConsumer::Frame frame;
+
+            if ( !consumer.AcquireNewest(frame) )
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            const cv::Mat matBitmap(format.height, format.width, format.type,
+                                    const_cast<void*>(frame.data), producer.GetFormat().rowStride);
+
+            converted = ConvertMatBitmapTowxImage(matBitmap, image);
+            consumer.Release(frame);
+            if ( !converted )
+                break;
+
+            latenciesUs.push_back((GetSharedFrameRingTimeNs() - frame.timestampNs) / 1000.);
+        }
+
+        const double elapsedMs = stopWatch.TimeInMicro().ToDouble() / 1000.;
+
+        stop = true;
+        producerThread.join();
+
+        if ( !converted )
+        {
+            fprintf(stderr, "Conversion failed.\n");
+            return 1;
+        }
+
+        const double consumedFps = latenciesUs.size() * 1000. / elapsedMs;
+        double       sumUs = 0.;
+
+        for ( const double latencyUs : latenciesUs )
+            sumUs += latencyUs;
+        std::sort(latenciesUs.begin(), latenciesUs.end());
+
+        wxString fields;
+
+        fields << wxString::Format("\"policy\": \"%s\", \"elapsedMs\": %.1f, \"framesConsumed\": %lu, ",
+                                   policyName, elapsedMs, static_cast<unsigned long>(latenciesUs.size()));
+        fields << wxString::Format("\"consumedFps\": %.1f, \"consumedGBPerSec\": %.3f, ",
+                                   consumedFps, consumedFps * frameMB / 1024.);
+        fields << wxString::Format("\"meanLatencyUs\": %.1f, \"p50LatencyUs\": %.1f, ",
+                                   sumUs / latenciesUs.size(), latenciesUs[latenciesUs.size() / 2]);
+        fields << wxString::Format("\"p99LatencyUs\": %.1f, \"maxLatencyUs\": %.1f, ",
+                                   latenciesUs[latenciesUs.size() * 99 / 100], latenciesUs.back());
+        fields << wxString::Format("\"published\": %llu, \"overwritten\": %llu, \"dropped\": %llu, \"skipped\": %llu",
+                                   static_cast<unsigned long long>(consumer.GetFramesPublished()),
+                                   static_cast<unsigned long long>(consumer.GetFramesOverwritten()),
+                                   static_cast<unsigned long long>(consumer.GetFramesDropped()),
+                                   static_cast<unsigned long long>(consumer.GetFramesSkipped()));
+        jsonWriter.AddResult(fields);
+    }
+
+    return 0;
+}
@@ -0,0 +1,112 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        ocvbenchstats.cpp
+// Purpose:     Frame statistics benchmark of the wxTestOpenCV benchmark program
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <wx/wx.h>
+
+#include <algorithm>
+#include <cstdint>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "framestatistics.h"
+#include "ocvbench.h"
+
+namespace
+{
+
+// Returns true if the histograms in statistics computed without
+// subsampling are the same as those computed by cv::calcHist().
+bool VerifyFrameStatistics(const cv::Mat& matBitmap, const FrameStatistics& statistics)
+{
+    const int    histSize = FrameStatistics::BinCount;
+    const float  range[] = { 0.f, 256.f };
+    const float* ranges[] = { range };
+
+    for ( int c = 0; c < statistics.channels; ++c )
+    {
+        cv::Mat hist;
+
+        cv::calcHist(&matBitmap, 1, &c, cv::Mat(), hist, 1, &histSize, ranges);
+
+        for ( int v = 0; v < histSize; ++v )
+        {
+            if ( static_cast<uint64_t>(hist.at<float>(v)) != statistics.histograms[c][v] )
+                return false;
+        }
+    }
+
+    return true;
+}
+
+} // unnamed namespace
+
+int BenchmarkFrameStatistics(const wxArrayString& selectedResolutions, const wxArrayString& selectedTypes,
+                             long minTimeMs, BenchJSONWriter& jsonWriter)
+{
+    for ( const auto& resolution : Resolutions )
+    {
+        if ( !IsNameSelected(selectedResolutions, resolution.name) )
+            continue;
+
+        for ( const int type : { CV_8UC1, CV_8UC3, CV_8UC4 } )
+        {
+            const wxString typeName(cv::typeToString(type));
+
+            if ( !IsNameSelected(selectedTypes, typeName) )
+                continue;
+
+            const cv::Mat matBitmap = CreateSourceMat(resolution.width, resolution.height, type, false);
+
+            for ( const int gridStep : { 1, 2, 4, 8 } )
+            {
+                FrameStatistics statistics;
+                double          sumMs = 0., minMs = 0.;
+                size_t          count = 0;
+                wxStopWatch     totalStopWatch, stopWatch;
+
+                fprintf(stderr, "Statistics %s %s, grid %d...\n", resolution.name,
+                        static_cast<const char*>(typeName.utf8_str()), gridStep);
+
+                do
+                {
+                    stopWatch.Start();
+                    ComputeFrameStatistics(matBitmap, gridStep, statistics);
+
+                    const double ms = stopWatch.TimeInMicro().ToDouble() / 1000.;
+
+                    sumMs += ms;
+                    minMs = count == 0 ? ms : std::min(minMs, ms);
+                    ++count;
+                } while ( totalStopWatch.Time() < minTimeMs || count < MinIterations );
+
+                if ( gridStep == 1 && !VerifyFrameStatistics(matBitmap, statistics) )
+                {
+                    fprintf(stderr, "Histograms differ from cv::calcHist().\n");
+                    return 1;
+                }
+
+                const double meanMs = sumMs / count;
+
+                wxString fields;
+
+                fields << wxString::Format("\"resolution\": \"%s\", \"type\": \"%s\", \"gridStep\": %d, ",
+                                           resolution.name, typeName, gridStep);
+                fields << wxString::Format("\"iterations\": %lu, \"meanMs\": %.4f, \"minMs\": %.4f, ",
+                                           static_cast<unsigned long>(count), meanMs, minMs);
+                // percentOf60FpsFrame is the share of the time between frames of a 60 fps camera
+                fields << wxString::Format("\"nsPerSample\": %.3f, \"percentOf60FpsFrame\": %.2f",
+                                           meanMs * 1e6 / statistics.sampleCount, meanMs * 60. / 10.);
+                jsonWriter.AddResult(fields);
+            }
+        }
+    }
+
+    return 0;
+}
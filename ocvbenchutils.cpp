@@ -0,0 +1,113 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        ocvbenchutils.cpp
+// Purpose:     Shared parts of the wxTestOpenCV benchmark program
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <wx/wx.h>
+#include <wx/ffile.h>
+
+#include <cstdio>
+
+#include "ocvbench.h"
+
+cv::Mat CreateSourceMat(int width, int height, int type, bool roi)
+{
+    const int    depth = CV_MAT_DEPTH(type);
+    const double maxVal = depth == CV_8U ? 256. : (depth == CV_16U ? 65536. : 1.);
+    cv::Mat      matBitmap(height, roi ? width + 32 : width, type);
+
+    cv::randu(matBitmap, cv::Scalar::all(0.), cv::Scalar::all(maxVal));
+
+    if ( roi )
+        return matBitmap(cv::Rect(16, 0, width, height));
+
+    return matBitmap;
+}
+
+bool IsNameSelected(const wxArrayString& selected, const wxString& name)
+{
+    return selected.empty() || selected.Index(name, false) != wxNOT_FOUND;
+}
+
+//
+// BenchJSONWriter
+//
+
+BenchJSONWriter::BenchJSONWriter()
+{
+    AddField("wxWidgets", wxVERSION_NUM_DOT_STRING);
+    AddField("OpenCV", CV_VERSION);
+    AddField("buildType", OCVBENCH_BUILD_TYPE);
+}
+
+void BenchJSONWriter::AddField(const wxString& name, const wxString& value)
+{
+    AddRawField(name, Quote(value));
+}
+
+void BenchJSONWriter::AddRawField(const wxString& name, const wxString& value)
+{
+    m_fields.push_back(wxString::Format("%s: %s", Quote(name), value));
+}
+
+void BenchJSONWriter::AddResult(const wxString& fields)
+{
+    m_results.push_back("{" + fields + "}");
+}
+
+wxString BenchJSONWriter::GetJSON() const
+{
+    wxString json;
+
+    json << "{\n";
+    for ( const auto& field : m_fields )
+        json << "  " << field << ",\n";
+
+    json << "  \"results\": [";
+    for ( size_t i = 0; i < m_results.size(); ++i )
+        json << (i == 0 ? "\n" : ",\n") << "    " << m_results[i];
+    json << "\n  ]\n}\n";
+
+    return json;
+}
+
+bool BenchJSONWriter::Write(const wxString& fileName) const
+{
+    const wxString json = GetJSON();
+
+    if ( fileName.empty() )
+    {
+        fputs(json.utf8_str(), stdout);
+        return true;
+    }
+
+    wxFFile file(fileName, "w");
+
+    if ( !file.IsOpened() || !file.Write(json) )
+    {
+        fprintf(stderr, "Could not write results to '%s'.\n", static_cast<const char*>(fileName.utf8_str()));
+        return false;
+    }
+
+    return true;
+}
+
+wxString BenchJSONWriter::Quote(const wxString& value)
+{
+    wxString quoted("\"");
+
+    for ( const auto& c : value )
+    {
+        if ( c == '"' || c == '\\' )
+            quoted << '\\';
+        quoted << c;
+    }
+
+    quoted << '"';
+
+    return quoted;
+}
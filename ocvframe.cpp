@@ -9,50 +9,324 @@
 
 #include <wx/wx.h>
 #include <wx/choicdlg.h>
+#include <wx/display.h>
 #include <wx/filedlg.h>
+#include <wx/filename.h>
 #include <wx/listctrl.h>
+#include <wx/numdlg.h>
 #include <wx/slider.h>
 #include <wx/textdlg.h>
+#include <wx/tokenzr.h>
 #include <wx/thread.h>
 #include <wx/utils.h>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
+
 #include <opencv2/opencv.hpp>
 
+#ifdef __WXGTK3__
+    #include <cairo.h>
+#endif
+
 #include "bmpfromocvpanel.h"
 #include "convertmattowxbmp.h"
+#include "frameprocessingchain.h"
+#include "framestatistics.h"
+#include "mappedimage.h"
 #include "ocvframe.h"
-
+#include "sharedframering.h"
+#include "videocaptureoptions.h"
+#include "videoexport.h"
+#include "videothumbnails.h"
+#include "videothumbnailstrip.h"
+
+// An attempt to open WebCam or IP Camera finished, successfully or not.
+wxDEFINE_EVENT(wxEVT_CAMERA_OPENED, wxThreadEvent);
 // A frame was retrieved from WebCam or IP Camera.
 wxDEFINE_EVENT(wxEVT_CAMERA_FRAME, wxThreadEvent);
 // Could not retrieve a frame, consider connection to the camera lost.
 wxDEFINE_EVENT(wxEVT_CAMERA_EMPTY, wxThreadEvent);
 // An exception was thrown in the camera thread.
 wxDEFINE_EVENT(wxEVT_CAMERA_EXCEPTION, wxThreadEvent);
+// Progress of the video export, the payload is VideoExportProgress.
+wxDEFINE_EVENT(wxEVT_VIDEO_EXPORT_PROGRESS, wxThreadEvent);
+// A video thumbnail was created, the payload is VideoThumbnail,
+// the extra long is the thumbnail job ID.
+wxDEFINE_EVENT(wxEVT_VIDEO_THUMBNAIL, wxThreadEvent);
+// Creating the video thumbnails finished, the payload is VideoThumbnailsResult,
+// the extra long is the thumbnail job ID.
+wxDEFINE_EVENT(wxEVT_VIDEO_THUMBNAILS_FINISHED, wxThreadEvent);
 
 //
-// Worker thread for retrieving images from WebCam or IP Camera
-// and sending them to the main thread for display.
-class CameraThread : public wxThread
+// Parameters of a camera being opened, shared between
+// OpenCVFrame and CameraOpenThread. When the opening is
+// cancelled, OpenCVFrame sets eventSink to nullptr and forgets
+// the request, the thread then just cleans up after itself.
+struct CameraOpenRequest
+{
+    // Identifies the request in wxEVT_CAMERA_OPENED handler,
+    // so that results of cancelled requests can be recognized.
+    unsigned long    id{0};
+
+    // If address is empty, the default webcam is used.
+    wxString         address;
+    // resolution and useMJPEG are used only for webcam.
+    wxSize           resolution;
+    bool             useMJPEG{false};
+    // Passed to the backend if OpenCV supports it.
+    long             timeout{0};
+    VideoCaptureOptions captureOptions;
+
+    wxCriticalSection eventSinkCS;
+    wxEvtHandler*    eventSink{nullptr};
+};
+
+//
+// Worker thread for opening WebCam or IP Camera without blocking the GUI.
+// It is detached, so the GUI never has to wait for it: when the request
+// is cancelled, the thread finishes whenever the backend returns control.
+// OpenCVFrame has at most one pending request, starting a new one cancels it.
+class CameraOpenThread : public wxThread
 {
 public:
-    struct CameraFrame
+    // Sent as wxEVT_CAMERA_OPENED payload (std::shared_ptr<Result>), so that
+    // the capture is released also when the event is never processed,
+    // e.g., when the frame is destroyed while the event is still queued.
+    struct Result
+    {
+        unsigned long                     requestId{0};
+        std::unique_ptr<cv::VideoCapture> capture; // empty if the camera could not be opened
+        wxString                          errorMessage;
+    };
+
+    CameraOpenThread(std::shared_ptr<CameraOpenRequest> request);
+
+protected:
+    std::shared_ptr<CameraOpenRequest> m_request;
+
+    ExitCode Entry() override;
+
+    cv::VideoCapture* OpenCapture(wxString& errorMessage);
+};
+
+CameraOpenThread::CameraOpenThread(std::shared_ptr<CameraOpenRequest> request)
+    : wxThread(wxTHREAD_DETACHED),
+      m_request(std::move(request))
+{
+    wxASSERT(m_request);
+}
+
+cv::VideoCapture* CameraOpenThread::OpenCapture(wxString& errorMessage)
+{
+    const bool        isDefaultWebCam = m_request->address.empty();
+    cv::VideoCapture* cap = nullptr;
+
+    try
+    {
+        // The timeout keeps the backend from blocking for much longer than
+        // the user is willing to wait, keeping this thread alive.
+        cap = new cv::VideoCapture;
+        if ( !OpenVideoCapture(*cap, m_request->address, m_request->captureOptions, m_request->timeout) )
+        {
+            wxDELETE(cap);
+            errorMessage = wxString::Format("Could not connect to the camera with %s.",
+                                            m_request->captureOptions.ToString());
+            return nullptr;
+        }
+
+        if ( isDefaultWebCam )
+        {
+            cap->set(cv::CAP_PROP_FRAME_WIDTH, m_request->resolution.GetWidth());
+            cap->set(cv::CAP_PROP_FRAME_HEIGHT, m_request->resolution.GetHeight());
+
+            if ( m_request->useMJPEG )
+                cap->set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
+        }
+    }
+    catch ( const std::exception& e )
+    {
+        wxDELETE(cap);
+        errorMessage = wxString::Format("Could not connect to the camera: %s", e.what());
+    }
+    catch ( ... )
+    {
+        wxDELETE(cap);
+        errorMessage = "Could not connect to the camera: Unknown exception";
+    }
+
+    return cap;
+}
+
+wxThread::ExitCode CameraOpenThread::Entry()
+{
+    std::shared_ptr<Result> result = std::make_shared<Result>();
+
+    result->requestId = m_request->id;
+    result->capture.reset(OpenCapture(result->errorMessage));
+
+    // When the request was cancelled, nobody is interested
+    // in the result and it is just released here.
+    wxCriticalSectionLocker locker(m_request->eventSinkCS);
+
+    if ( m_request->eventSink )
+    {
+        wxThreadEvent* evt = new wxThreadEvent(wxEVT_CAMERA_OPENED);
+
+        evt->SetPayload(result);
+        m_request->eventSink->QueueEvent(evt);
+    }
+
+    return static_cast<wxThread::ExitCode>(nullptr);
+}
+
+//
+// Image retrieved from WebCam, IP Camera, or shared memory.
+struct CameraFrame
+{
+    cv::Mat       matBitmap;
+    long          timeGet{0};
+    wxString      processingError; // not empty if the processing failed
+    unsigned long sessionId{0};    // see OpenCVFrame::m_cameraSessionId
+};
+
+//
+// Passes the frame through processingChain (if not nullptr and it has
+// any stages) or queues it directly to eventSink. Takes ownership of the frame.
+// The stages can change anytime, so it is checked for every frame.
+void DeliverCameraFrame(wxEvtHandler* eventSink, FrameProcessingChain* processingChain, CameraFrame* frame)
+{
+    if ( processingChain && processingChain->HasStages() )
+    {
+        // the frame is dropped when the processing cannot keep up
+        processingChain->Submit(frame->matBitmap, frame->timeGet);
+        delete frame;
+        return;
+    }
+
+    wxThreadEvent* evt = new wxThreadEvent(wxEVT_CAMERA_FRAME);
+
+    evt->SetPayload(frame);
+    eventSink->QueueEvent(evt);
+}
+
+//
+// Processing stages the user can choose from. Each of them
+// can process CV_8UC1, CV_8UC3, and CV_8UC4 Mats, i.e.,
+// the Mat types WebCam and IP Camera provide.
+namespace
+{
+
+const std::vector<FrameProcessingStage>& GetAvailableProcessingStages()
+{
+    static const std::vector<FrameProcessingStage> stages =
     {
-        cv::Mat matBitmap;
-        long    timeGet{0};
+        { "Gaussian blur", [](const cv::Mat& in)
+            {
+                cv::Mat out;
+
+                cv::GaussianBlur(in, out, cv::Size(5, 5), 0);
+                return out;
+            }
+        },
+        { "Denoise (median)", [](const cv::Mat& in)
+            {
+                cv::Mat out;
+
+                cv::medianBlur(in, out, 5);
+                return out;
+            }
+        },
+        { "Denoise (bilateral)", [](const cv::Mat& in)
+            {
+                cv::Mat in3, out;
+
+                // bilateralFilter() does not support 4-channel Mats
+                if ( in.channels() == 4 )
+                    cv::cvtColor(in, in3, cv::COLOR_BGRA2BGR);
+                else
+                    in3 = in;
+
+                cv::bilateralFilter(in3, out, 9, 50., 50.);
+                return out;
+            }
+        },
+        { "Edges (Canny)", [](const cv::Mat& in)
+            {
+                cv::Mat gray, out;
+
+                if ( in.channels() == 3 )
+                    cv::cvtColor(in, gray, cv::COLOR_BGR2GRAY);
+                else if ( in.channels() == 4 )
+                    cv::cvtColor(in, gray, cv::COLOR_BGRA2GRAY);
+                else
+                    gray = in;
+
+                cv::Canny(gray, out, 50., 150.);
+                return out;
+            }
+        },
     };
 
-    CameraThread(wxEvtHandler* eventSink, cv::VideoCapture* camera);
+    return stages;
+}
+
+// Reads the image file keeping its depth, channels, and alpha
+// where ConvertMatBitmapTowxBitmap() supports them. Returns an empty Mat
+// if the file could not be read.
+cv::Mat ReadImage(const wxString& fileName)
+{
+    const std::string name = fileName.ToStdString();
+    const wxString    ext = wxFileName(fileName).GetExt().Lower();
+    cv::Mat           matBitmap;
+
+    // JPEG has no alpha but often has EXIF orientation, which
+    // IMREAD_UNCHANGED ignores while the other flags apply it.
+    if ( ext == "jpg" || ext == "jpeg" )
+        matBitmap = cv::imread(name, cv::IMREAD_ANYDEPTH | cv::IMREAD_ANYCOLOR);
+    else
+        matBitmap = cv::imread(name, cv::IMREAD_UNCHANGED);
+
+    if ( matBitmap.empty() || GetwxBitmapDepthForMatBitmap(matBitmap) != 0 )
+        return matBitmap;
+
+    // A type the conversion does not support (e.g., 16-bit with alpha or grayscale
+    // with alpha): drop the alpha, keeping the depth if supported, else load as 8-bit BGR.
+    matBitmap = cv::imread(name, cv::IMREAD_ANYDEPTH | cv::IMREAD_ANYCOLOR);
+    if ( matBitmap.empty() || GetwxBitmapDepthForMatBitmap(matBitmap) != 0 )
+        return matBitmap;
+
+    return cv::imread(name, cv::IMREAD_COLOR);
+}
+
+} // unnamed namespace
+
+//
+// Worker thread for retrieving images from WebCam or IP Camera
+// and sending them to the main thread for display.
+// When processingChain is not nullptr, the frames are
+// sent to the main thread through it instead of directly.
+class CameraThread : public wxThread
+{
+public:
+    // sessionId is set to the frames sent directly
+    CameraThread(wxEvtHandler* eventSink, cv::VideoCapture* camera, unsigned long sessionId,
+                 FrameProcessingChain* processingChain = nullptr);
 
 protected:
-    wxEvtHandler*     m_eventSink{nullptr};
-    cv::VideoCapture* m_camera{nullptr};
+    wxEvtHandler*         m_eventSink{nullptr};
+    cv::VideoCapture*     m_camera{nullptr};
+    unsigned long         m_sessionId{0};
+    FrameProcessingChain* m_processingChain{nullptr};
 
     ExitCode Entry() override;
 };
 
-CameraThread::CameraThread(wxEvtHandler* eventSink, cv::VideoCapture* camera)
+CameraThread::CameraThread(wxEvtHandler* eventSink, cv::VideoCapture* camera, unsigned long sessionId,
+                           FrameProcessingChain* processingChain)
     : wxThread(wxTHREAD_JOINABLE),
-      m_eventSink(eventSink), m_camera(camera)
+      m_eventSink(eventSink), m_camera(camera), m_sessionId(sessionId), m_processingChain(processingChain)
 {
     wxASSERT(m_eventSink);
     wxASSERT(m_camera);
@@ -69,16 +343,15 @@ wxThread::ExitCode CameraThread::Entry()
         try
         {
             frame = new CameraFrame;
+            frame->sessionId = m_sessionId;
             stopWatch.Start();
             (*m_camera) >> frame->matBitmap;
             frame->timeGet = stopWatch.Time();
 
             if ( !frame->matBitmap.empty() )
             {
-                wxThreadEvent* evt = new wxThreadEvent(wxEVT_CAMERA_FRAME);
-
-                evt->SetPayload(frame);
-                m_eventSink->QueueEvent(evt);
+                DeliverCameraFrame(m_eventSink, m_processingChain, frame);
+                frame = nullptr;
                 // In a real code, the duration to sleep would normally
                 // be computed based on the camera framerate, time taken
                 // to process the image, and system clock tick resolution.
@@ -114,6 +387,132 @@ wxThread::ExitCode CameraThread::Entry()
     return static_cast<wxThread::ExitCode>(nullptr);
 }
 
+//
+// Lets a Mat wrap a frame in SharedFrameRingConsumer without copying
+// and keeps the frame held as long as any Mat references its data
+// (e.g., a frame waiting for presentation, the previous frame kept
+// for the incremental update, or a frame being processed),
+// the last Mat destroyed gives the slot back to the producer.
+class SharedFrameRingMatAllocator : public cv::MatAllocator
+{
+public:
+    static cv::Mat WrapFrame(const std::shared_ptr<SharedFrameRingConsumer>& ring,
+                             const SharedFrameRingConsumer::Frame& frame)
+    {
+        static const SharedFrameRingMatAllocator allocator;
+
+        const SharedFrameRingFormat& format = ring->GetFormat();
+        cv::Mat                      matBitmap(format.height, format.width, format.type,
+                                               const_cast<void*>(frame.data), format.rowStride);
+        FrameData*                   frameData = new FrameData(&allocator);
+
+        frameData->data = frameData->origdata = matBitmap.data;
+        frameData->size = format.rowStride * format.height;
+        frameData->refcount = 1;
+        frameData->ring = ring;
+        frameData->frame = frame;
+
+        // Mat::allocator is not set, so the Mats created from this one
+        // (e.g., by Mat::create()) use the default allocator.
+        matBitmap.u = frameData;
+        return matBitmap;
+    }
+
+    // Mats are never allocated by this allocator, only wrapped.
+    cv::UMatData* allocate(int, const int*, int, void*, size_t*,
+                           cv::AccessFlag, cv::UMatUsageFlags) const override
+    {
+        return nullptr;
+    }
+
+    bool allocate(cv::UMatData*, cv::AccessFlag, cv::UMatUsageFlags) const override
+    {
+        return false;
+    }
+
+    // called when the last Mat referencing the data is released
+    void deallocate(cv::UMatData* data) const override
+    {
+        FrameData* frameData = static_cast<FrameData*>(data);
+
+        frameData->ring->Release(frameData->frame);
+        delete frameData;
+    }
+
+private:
+    struct FrameData : public cv::UMatData
+    {
+        FrameData(const cv::MatAllocator* allocator) : cv::UMatData(allocator) {}
+
+        // the consumer must exist as long as it has frames held
+        std::shared_ptr<SharedFrameRingConsumer> ring;
+        SharedFrameRingConsumer::Frame           frame;
+    };
+};
+
+//
+// Worker thread retrieving the newest frames from a shared-memory
+// ring written by another process (see SharedFrameRingProducer).
+class SharedFrameRingThread : public wxThread
+{
+public:
+    // sessionId is set to the frames sent directly
+    SharedFrameRingThread(wxEvtHandler* eventSink, std::shared_ptr<SharedFrameRingConsumer> ring,
+                          unsigned long sessionId, FrameProcessingChain* processingChain = nullptr);
+
+protected:
+    wxEvtHandler*                            m_eventSink{nullptr};
+    std::shared_ptr<SharedFrameRingConsumer> m_ring;
+    unsigned long                            m_sessionId{0};
+    FrameProcessingChain*                    m_processingChain{nullptr};
+
+    ExitCode Entry() override;
+};
+
+SharedFrameRingThread::SharedFrameRingThread(wxEvtHandler* eventSink, std::shared_ptr<SharedFrameRingConsumer> ring,
+                                             unsigned long sessionId, FrameProcessingChain* processingChain)
+    : wxThread(wxTHREAD_JOINABLE),
+      m_eventSink(eventSink), m_ring(std::move(ring)), m_sessionId(sessionId), m_processingChain(processingChain)
+{
+    wxASSERT(m_eventSink);
+    wxASSERT(m_ring && m_ring->IsOpened());
+}
+
+wxThread::ExitCode SharedFrameRingThread::Entry()
+{
+    while ( !TestDestroy() )
+    {
+        SharedFrameRingConsumer::Frame ringFrame;
+
+        // Fails also when the viewer holds too many frames,
+        // e.g., when their presentation cannot keep up.
+        if ( !m_ring->AcquireNewest(ringFrame) )
+        {
+            if ( m_ring->IsProducerClosed() )
+            {
+                m_eventSink->QueueEvent(new wxThreadEvent(wxEVT_CAMERA_EMPTY));
+                break;
+            }
+
+            // The ring is lock-free, so there is nothing to wait on,
+            // poll often enough not to add a noticeable latency.
+            wxMilliSleep(1);
+            continue;
+        }
+
+        CameraFrame* frame = new CameraFrame;
+
+        frame->sessionId = m_sessionId;
+        frame->matBitmap = SharedFrameRingMatAllocator::WrapFrame(m_ring, ringFrame);
+        // the latency, i.e., the time since the producer published the frame
+        frame->timeGet = static_cast<long>((GetSharedFrameRingTimeNs() - ringFrame.timestampNs) / 1000000);
+
+        DeliverCameraFrame(m_eventSink, m_processingChain, frame);
+    }
+
+    return static_cast<wxThread::ExitCode>(nullptr);
+}
+
 //
 // OpenCVFrame
 //
@@ -123,7 +522,7 @@ OpenCVFrame::OpenCVFrame()
     wxPanel*    mainPanel = new wxPanel(this);
     wxBoxSizer* mainPanelSizer = new wxBoxSizer(wxVERTICAL);
     wxBoxSizer* buttonSizer = new wxBoxSizer(wxHORIZONTAL);
-    wxBoxSizer* bottomSizer = new wxBoxSizer(wxHORIZONTAL); // Properties button and wxSlider
+    wxBoxSizer* bottomSizer = new wxBoxSizer(wxHORIZONTAL); // Properties button, presentation mode, wxSlider, and camera connection status
     wxButton*   button = nullptr;
 
     button = new wxButton(mainPanel, wxID_ANY, "&Image...");
@@ -142,6 +541,11 @@ OpenCVFrame::OpenCVFrame()
     button->Bind(wxEVT_BUTTON, &OpenCVFrame::OnIPCamera, this);
     buttonSizer->Add(button, wxSizerFlags().Proportion(1).Expand().Border());
 
+    button = new wxButton(mainPanel, wxID_ANY, "S&hared Memory...");
+    button->SetToolTip("Show frames another process writes into a shared-memory ring");
+    button->Bind(wxEVT_BUTTON, &OpenCVFrame::OnSharedMemory, this);
+    buttonSizer->Add(button, wxSizerFlags().Proportion(1).Expand().Border());
+
     buttonSizer->AddSpacer(FromDIP(20));
 
     button = new wxButton(mainPanel, wxID_ANY, "&Clear");
@@ -150,18 +554,67 @@ OpenCVFrame::OpenCVFrame()
 
     m_bitmapPanel = new wxBitmapFromOpenCVPanel(mainPanel);
 
+    m_videoThumbnailStrip = new wxVideoThumbnailStrip(mainPanel);
+    m_videoThumbnailStrip->SetToolTip("Click or drag to go to a frame of the video");
+    m_videoThumbnailStrip->Bind(wxEVT_VIDEO_THUMBNAIL_STRIP, &OpenCVFrame::OnVideoThumbnailStrip, this);
+
     m_propertiesButton = new wxButton(mainPanel, wxID_ANY, "P&roperties...");
     m_propertiesButton->Bind(wxEVT_BUTTON, &OpenCVFrame::OnProperties, this);
     bottomSizer->Add(m_propertiesButton, wxSizerFlags().Expand().Border());
 
+    button = new wxButton(mainPanel, wxID_ANY, "Capture &Options...");
+    button->SetToolTip("Select the backend and decoder options used when opening a video or camera");
+    button->Bind(wxEVT_BUTTON, &OpenCVFrame::OnCaptureOptions, this);
+    bottomSizer->Add(button, wxSizerFlags().Expand().Border());
+
+    button = new wxButton(mainPanel, wxID_ANY, "Processin&g...");
+    button->SetToolTip("Select the processing applied to camera frames before they are displayed");
+    button->Bind(wxEVT_BUTTON, &OpenCVFrame::OnProcessing, this);
+    bottomSizer->Add(button, wxSizerFlags().Expand().Border());
+
+    m_exportButton = new wxButton(mainPanel, wxID_ANY, "E&xport...");
+    m_exportButton->SetToolTip("Export a range of the video frames, with the selected processing applied");
+    m_exportButton->Bind(wxEVT_BUTTON, &OpenCVFrame::OnExport, this);
+    bottomSizer->Add(m_exportButton, wxSizerFlags().Expand().Border());
+
+    wxCheckBox* presentOnIdleCheckBox = new wxCheckBox(mainPanel, wxID_ANY, "Present on i&dle");
+    presentOnIdleCheckBox->SetToolTip("Present camera frames whenever the application is idle instead of once per display refresh");
+    presentOnIdleCheckBox->SetValue(m_presentOnIdle);
+    presentOnIdleCheckBox->Bind(wxEVT_CHECKBOX, &OpenCVFrame::OnPresentOnIdle, this);
+    bottomSizer->Add(presentOnIdleCheckBox, wxSizerFlags().CenterVertical().Border());
+
+    wxCheckBox* incrementalUpdateCheckBox = new wxCheckBox(mainPanel, wxID_ANY, "Incremental &update");
+    incrementalUpdateCheckBox->SetToolTip("Convert and repaint only the parts of a camera frame which changed since the previous one");
+    incrementalUpdateCheckBox->SetValue(m_incrementalUpdate);
+    incrementalUpdateCheckBox->Bind(wxEVT_CHECKBOX, &OpenCVFrame::OnIncrementalUpdate, this);
+    bottomSizer->Add(incrementalUpdateCheckBox, wxSizerFlags().CenterVertical().Border());
+
+    wxCheckBox* statisticsCheckBox = new wxCheckBox(mainPanel, wxID_ANY, "S&tatistics");
+    statisticsCheckBox->SetToolTip("Show histograms and exposure statistics of camera frames, computed in the processing threads");
+    statisticsCheckBox->Bind(wxEVT_CHECKBOX, &OpenCVFrame::OnStatistics, this);
+    bottomSizer->Add(statisticsCheckBox, wxSizerFlags().CenterVertical().Border());
+
     m_videoSlider = new wxSlider(mainPanel, wxID_ANY, 0, 0, 100, wxDefaultPosition, wxDefaultSize, wxSL_LABELS);
     m_videoSlider->Bind(wxEVT_SLIDER, &OpenCVFrame::OnVideoSetFrame, this);
     bottomSizer->Add(m_videoSlider, wxSizerFlags().Proportion(1).Expand().Border().ReserveSpaceEvenIfHidden());
 
+    m_cameraOpenStatusText = new wxStaticText(mainPanel, wxID_ANY, "");
+    m_cameraOpenStatusText->Hide();
+    bottomSizer->Add(m_cameraOpenStatusText, wxSizerFlags().CenterVertical().Border());
+
+    m_cameraOpenCancelButton = new wxButton(mainPanel, wxID_ANY, "Ca&ncel");
+    m_cameraOpenCancelButton->Bind(wxEVT_BUTTON, &OpenCVFrame::OnCameraOpenCancel, this);
+    m_cameraOpenCancelButton->Hide();
+    bottomSizer->Add(m_cameraOpenCancelButton, wxSizerFlags().Expand().Border());
+
     mainPanelSizer->Add(buttonSizer, wxSizerFlags().Expand().Border());
     mainPanelSizer->Add(m_bitmapPanel, wxSizerFlags().Proportion(1).Expand());
+    mainPanelSizer->Add(m_videoThumbnailStrip, wxSizerFlags().Expand().Border(wxLEFT | wxRIGHT | wxTOP).ReserveSpaceEvenIfHidden());
     mainPanelSizer->Add(bottomSizer, wxSizerFlags().Expand().Border());
 
+    // the first field is for the export, the second one for the thumbnails
+    CreateStatusBar(2);
+
     SetMinClientSize(FromDIP(wxSize(600, 400)));
     SetSize(FromDIP(wxSize(800, 600)));
 
@@ -169,27 +622,54 @@ OpenCVFrame::OpenCVFrame()
 
     Clear();
 
+    m_cameraOpenTimer.SetOwner(this);
+    Bind(wxEVT_TIMER, &OpenCVFrame::OnCameraOpenTimer, this, m_cameraOpenTimer.GetId());
+
+    m_presentTimer.SetOwner(this);
+    Bind(wxEVT_TIMER, &OpenCVFrame::OnPresentTimer, this, m_presentTimer.GetId());
+    Bind(wxEVT_IDLE, &OpenCVFrame::OnIdle, this);
+
+    Bind(wxEVT_CAMERA_OPENED, &OpenCVFrame::OnCameraOpened, this);
     Bind(wxEVT_CAMERA_FRAME, &OpenCVFrame::OnCameraFrame, this);
     Bind(wxEVT_CAMERA_EMPTY, &OpenCVFrame::OnCameraEmpty, this);
     Bind(wxEVT_CAMERA_EXCEPTION, &OpenCVFrame::OnCameraException, this);
+    Bind(wxEVT_VIDEO_EXPORT_PROGRESS, &OpenCVFrame::OnVideoExportProgress, this);
+    Bind(wxEVT_VIDEO_THUMBNAIL, &OpenCVFrame::OnVideoThumbnail, this);
+    Bind(wxEVT_VIDEO_THUMBNAILS_FINISHED, &OpenCVFrame::OnVideoThumbnailsFinished, this);
 }
 
 OpenCVFrame::~OpenCVFrame()
 {
+    CancelCameraOpen();
     DeleteCameraThread();
+    // must be deleted after the camera thread which uses it
+    wxDELETE(m_processingChain);
+    // cancels the export if it is still running
+    wxDELETE(m_videoExportJob);
+    DeleteVideoThumbnailJob();
+    ResetPresentation();
 }
 
-wxBitmap OpenCVFrame::ConvertMatToBitmap(const cv::Mat& matBitmap, long& timeConvert)
+wxBitmap OpenCVFrame::ConvertMatToBitmap(const cv::Mat& matBitmap, long& timeConvert,
+                                         const MatBitmapConversionOptions& options)
 {
     wxCHECK(!matBitmap.empty(), wxBitmap());
 
-    wxBitmap    bitmap(matBitmap.cols, matBitmap.rows, 24);
+    const int depth = GetwxBitmapDepthForMatBitmap(matBitmap, options);
+
+    if ( depth == 0 )
+    {
+        wxLogError("Unsupported Mat type %s.", wxString(cv::typeToString(matBitmap.type())));
+        return wxBitmap();
+    }
+
+    wxBitmap    bitmap(matBitmap.cols, matBitmap.rows, depth);
     bool        converted = false;
     wxStopWatch stopWatch;
     long        time = 0;
 
     stopWatch.Start();
-    converted = ConvertMatBitmapTowxBitmap(matBitmap, bitmap);
+    converted = ConvertMatBitmapTowxBitmap(matBitmap, bitmap, options);
     time = stopWatch.Time();
 
     if ( !converted )
@@ -202,139 +682,507 @@ wxBitmap OpenCVFrame::ConvertMatToBitmap(const cv::Mat& matBitmap, long& timeCon
     return bitmap;
 }
 
-void OpenCVFrame::Clear()
+bool OpenCVFrame::ShowMatBitmap(const cv::Mat& matBitmap, long timeGet,
+                                const MatBitmapConversionOptions& options)
 {
-    DeleteCameraThread();
+    long timeConvert = 0;
 
-    if ( m_videoCapture )
-        wxDELETE(m_videoCapture);
+#ifdef __WXGTK3__
+    if ( GetwxBitmapDepthForMatBitmap(matBitmap, options) != 0 )
+    {
+        const cairo_format_t format = GetwxBitmapDepthForMatBitmap(matBitmap, options) == 32
+                                      ? CAIRO_FORMAT_ARGB32 : CAIRO_FORMAT_RGB24;
+        cairo_surface_t*     surface = m_bitmapPanel->GetSurface();
+        wxStopWatch          stopWatch;
+
+        // Converting into the displayed surface saves allocating
+        // (and clearing) a new one for every frame of a video.
+        if ( surface
+             && cairo_image_surface_get_format(surface) == format
+             && cairo_image_surface_get_width(surface) == matBitmap.cols
+             && cairo_image_surface_get_height(surface) == matBitmap.rows )
+        {
+            stopWatch.Start();
+            if ( ConvertMatBitmapToCairoSurface(matBitmap, surface, options) )
+            {
+                timeConvert = stopWatch.Time();
+                m_bitmapPanel->UpdateSurface(std::vector<wxRect>{ wxRect(0, 0, matBitmap.cols, matBitmap.rows) },
+                                             timeGet, timeConvert);
+                return true;
+            }
+        }
+        else
+        {
+            surface = cairo_image_surface_create(format, matBitmap.cols, matBitmap.rows);
 
-    m_mode = Empty;
-    m_sourceName.clear();
-    m_currentVideoFrameNumber = 0;
+            stopWatch.Start();
+            if ( cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS
+                 && ConvertMatBitmapToCairoSurface(matBitmap, surface, options) )
+            {
+                timeConvert = stopWatch.Time();
+                m_bitmapPanel->SetSurface(surface, timeGet, timeConvert);
+                return true;
+            }
 
-    m_bitmapPanel->SetBitmap(wxBitmap(), 0, 0);
-    m_videoSlider->SetValue(0);
-    m_videoSlider->SetRange(0, 1);
-    m_videoSlider->Disable();
-    m_videoSlider->Hide();
+            cairo_surface_destroy(surface);
+        }
 
-    m_propertiesButton->Disable();
+        wxLogError("Could not convert Mat to cairo surface.");
+        m_bitmapPanel->SetBitmap(wxBitmap(), 0, 0);
+        return false;
+    }
+#endif // #ifdef __WXGTK3__
 
-    UpdateFrameTitle();
+    const wxBitmap bitmap = ConvertMatToBitmap(matBitmap, timeConvert, options);
+
+    if ( !bitmap.IsOk() )
+    {
+        m_bitmapPanel->SetBitmap(wxBitmap(), 0, 0);
+        return false;
+    }
+
+    m_bitmapPanel->SetBitmap(bitmap, timeGet, timeConvert);
+    return true;
 }
 
-void OpenCVFrame::UpdateFrameTitle()
+bool OpenCVFrame::ShowMatBitmapTiles(const cv::Mat& matBitmap, long timeGet)
 {
-    wxString modeStr;
+    // Tiles small enough to follow the outline of a moving object
+    // but not so small that the per-tile overhead would dominate.
+    static const int tileSize = 32;
 
-    switch ( m_mode )
+    if ( m_displayedMatBitmap.size() != matBitmap.size()
+         || m_displayedMatBitmap.type() != matBitmap.type()
+         || m_bitmapPanel->GetBitmapSize() != wxSize(matBitmap.cols, matBitmap.rows) )
     {
-        case Empty:
-            modeStr = "Empty";
-            break;
-        case Image:
-            modeStr = "Image";
-            break;
-        case Video:
-            modeStr = "Video";
-            break;
-        case WebCam:
-            modeStr = "WebCam";
-            break;
-        case IPCamera:
-            modeStr = "IP Camera";
-            break;
+        return false;
     }
 
-    SetTitle(wxString::Format("wxOpenCVTest: %s", modeStr));
-}
+    // Ignore the sensor noise, which would otherwise make
+    // every tile of a static scene changed.
+    double threshold = 4.;
 
-void OpenCVFrame::ShowVideoFrame(int frameNumber)
-{
-    const int   captureFrameNumber = (int)(m_videoCapture->get(cv::CAP_PROP_POS_FRAMES));
-    cv::Mat     matBitmap;
-    wxStopWatch stopWatch;
-    long        timeGet = 0;
+    if ( matBitmap.depth() == CV_16U )
+        threshold *= 256.;
+    else if ( matBitmap.depth() == CV_32F )
+        threshold /= 255.;
+
+    std::vector<wxRect> tiles;
+    wxStopWatch         stopWatch;
+    double              tilesArea = 0.;
 
     stopWatch.Start();
-    if ( frameNumber != captureFrameNumber)
-        m_videoCapture->set(cv::VideoCaptureProperties::CAP_PROP_POS_FRAMES, frameNumber);
-    (*m_videoCapture) >> matBitmap;
-    timeGet = stopWatch.Time();
 
-    if ( matBitmap.empty() )
+    if ( !GetChangedMatBitmapTiles(matBitmap, m_displayedMatBitmap, tileSize, threshold, tiles) )
+        return false;
+
+#ifdef __WXGTK3__
+    cairo_surface_t* surface = m_bitmapPanel->GetSurface();
+
+    if ( !surface
+         || (cairo_image_surface_get_format(surface) == CAIRO_FORMAT_ARGB32) != (matBitmap.type() == CV_8UC4)
+         || !ConvertMatBitmapToCairoSurface(matBitmap, surface, tiles) )
     {
-        m_bitmapPanel->SetBitmap(wxBitmap(), 0, 0);
-        wxLogError("Could not retrieve frame %d.", frameNumber);
-        return;
+        return false;
     }
 
-    wxBitmap bitmap;
-    long     timeConvert = 0;
+    const double timeConvert = stopWatch.TimeInMicro().ToDouble() / 1000.;
 
-    bitmap = ConvertMatToBitmap(matBitmap, timeConvert);
+    m_bitmapPanel->UpdateSurface(tiles, timeGet, static_cast<long>(timeConvert));
+#else
+    wxBitmap bitmap = m_bitmapPanel->GetBitmap();
 
-    if ( !bitmap.IsOk() )
+    if ( !bitmap.IsOk()
+         || bitmap.GetDepth() != GetwxBitmapDepthForMatBitmap(matBitmap)
+         || !ConvertMatBitmapTowxBitmap(matBitmap, bitmap, tiles) )
     {
-        m_bitmapPanel->SetBitmap(wxBitmap(), 0, 0);
-        wxLogError("Could not convert frame %d to wxBitmap.", frameNumber);
-        return;
+        return false;
     }
 
-    m_bitmapPanel->SetBitmap(bitmap, timeGet, timeConvert);
+    const double timeConvert = stopWatch.TimeInMicro().ToDouble() / 1000.;
+
+    m_bitmapPanel->UpdateBitmap(bitmap, tiles, timeGet, static_cast<long>(timeConvert));
+#endif // #ifdef __WXGTK3__
+
+    for ( const wxRect& tile : tiles )
+    {
+        const cv::Rect rect(tile.x, tile.y, tile.width, tile.height);
+
+        matBitmap(rect).copyTo(m_displayedMatBitmap(rect));
+        tilesArea += static_cast<double>(tile.width) * tile.height;
+    }
+
+    m_updatedFraction = tilesArea / (static_cast<double>(matBitmap.cols) * matBitmap.rows);
+    m_timeSaved = m_fullConvertTime - timeConvert;
+    m_bitmapPanel->SetIncrementalUpdateStats(m_updatedFraction, m_timeSaved);
+
+    return true;
 }
 
-bool OpenCVFrame::StartCameraCapture(const wxString& address, const wxSize& resolution,
-                                     bool useMJPEG)
+void OpenCVFrame::ShowCameraFrame(CameraFrame* frame)
 {
-    const bool        isDefaultWebCam = address.empty();
-    cv::VideoCapture* cap = nullptr;
-
-    Clear();
+    if ( !m_incrementalUpdate )
+    {
+        ShowMatBitmap(frame->matBitmap, frame->timeGet);
+        delete frame;
+        return;
+    }
 
+    if ( m_displayedMatBitmap.empty()
+         || !ShowMatBitmapTiles(frame->matBitmap, frame->timeGet) )
     {
-        wxWindowDisabler disabler;
-        wxBusyCursor     busyCursor;
+        wxStopWatch stopWatch;
 
-        if ( isDefaultWebCam )
-            cap = new cv::VideoCapture(0);
+        stopWatch.Start();
+        if ( ShowMatBitmap(frame->matBitmap, frame->timeGet) )
+        {
+            m_fullConvertTime = stopWatch.TimeInMicro().ToDouble() / 1000.;
+            // Copied rather than shared, the frame data may belong
+            // to a slot of the shared ring, which must not be held.
+            frame->matBitmap.copyTo(m_displayedMatBitmap);
+        }
         else
-            cap = new cv::VideoCapture(address.ToStdString());
+        {
+            m_displayedMatBitmap.release();
+        }
+
+        m_updatedFraction = 1.0;
+        m_timeSaved = 0.0;
+        m_bitmapPanel->SetIncrementalUpdateStats(m_updatedFraction, m_timeSaved);
     }
 
-    if ( !cap->isOpened() )
+    delete frame;
+}
+
+void OpenCVFrame::Clear()
+{
+    CancelCameraOpen();
+    DeleteCameraThread();
+
+    // The frames of this session still being processed are delivered
+    // with its ID, so that they (and those already queued) are dropped.
+    if ( m_processingChain )
+        m_processingChain->WaitUntilDelivered();
+    ++m_cameraSessionId;
+
+    ResetPresentation();
+    DeleteVideoThumbnailJob();
+
+    if ( m_videoCapture )
+        wxDELETE(m_videoCapture);
+
+    // frames still referenced (e.g., by unprocessed events) keep it open
+    m_sharedFrameRing.reset();
+
+    m_mode = Empty;
+    m_sourceName.clear();
+    m_currentVideoFrameNumber = 0;
+
+    m_bitmapPanel->SetBitmap(wxBitmap(), 0, 0);
+    m_videoSlider->SetValue(0);
+    m_videoSlider->SetRange(0, 1);
+    m_videoSlider->Disable();
+    m_videoSlider->Hide();
+    m_videoThumbnailStrip->Reset(0, 0);
+    m_videoThumbnailStrip->Hide();
+    SetStatusText("", 1);
+
+    m_propertiesButton->Disable();
+    // the export is independent on the opened source and can be cancelled anytime
+    m_exportButton->Enable(m_videoExportJob != nullptr);
+
+    UpdateFrameTitle();
+}
+
+void OpenCVFrame::UpdateFrameTitle()
+{
+    wxString modeStr;
+
+    switch ( m_mode )
     {
-        delete cap;
-        wxLogError("Could not connect to the camera.");
-        return false;
+        case Empty:
+            modeStr = "Empty";
+            break;
+        case Image:
+            modeStr = "Image";
+            break;
+        case Video:
+            modeStr = "Video";
+            break;
+        case WebCam:
+            modeStr = "WebCam";
+            break;
+        case IPCamera:
+            modeStr = "IP Camera";
+            break;
+        case SharedMemory:
+            modeStr = "Shared Memory";
+            break;
     }
 
-    m_videoCapture = cap;
+    SetTitle(wxString::Format("wxOpenCVTest: %s", modeStr));
+}
 
-    if ( isDefaultWebCam )
-    {
-        m_videoCapture->set(cv::CAP_PROP_FRAME_WIDTH, resolution.GetWidth());
-        m_videoCapture->set(cv::CAP_PROP_FRAME_HEIGHT, resolution.GetHeight());
+void OpenCVFrame::ShowVideoFrame(int frameNumber)
+{
+    const int   captureFrameNumber = (int)(m_videoCapture->get(cv::CAP_PROP_POS_FRAMES));
+    cv::Mat     matBitmap;
+    wxStopWatch stopWatch;
+    long        timeGet = 0;
+
+    stopWatch.Start();
+    if ( frameNumber != captureFrameNumber)
+        m_videoCapture->set(cv::VideoCaptureProperties::CAP_PROP_POS_FRAMES, frameNumber);
+    (*m_videoCapture) >> matBitmap;
+    timeGet = stopWatch.Time();
 
-        if ( useMJPEG )
-            m_videoCapture->set(cv::CAP_PROP_FOURCC, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'));
+    if ( matBitmap.empty() )
+    {
+        m_bitmapPanel->SetBitmap(wxBitmap(), 0, 0);
+        wxLogError("Could not retrieve frame %d.", frameNumber);
+        return;
     }
 
-    if ( !StartCameraThread() )
+    if ( !ShowMatBitmap(matBitmap, timeGet) )
+        wxLogError("Could not convert frame %d to wxBitmap.", frameNumber);
+
+    m_videoThumbnailStrip->SetCurrentFrame(frameNumber);
+}
+
+void OpenCVFrame::StartVideoThumbnails()
+{
+    wxCHECK_RET(m_mode == Video && m_videoCapture, "Thumbnails require an opened video");
+
+    DeleteVideoThumbnailJob();
+
+    const long            jobId = ++m_videoThumbnailJobId;
+    const int             frameCount = static_cast<int>(m_videoCapture->get(cv::CAP_PROP_FRAME_COUNT));
+    VideoThumbnailOptions options;
+
+    options.fileName = m_sourceName;
+    options.captureOptions = m_videoCaptureOptions;
+
+    m_videoThumbnailStrip->Reset(frameCount, std::min(options.thumbnailCount, frameCount));
+    m_videoThumbnailStrip->Show();
+    m_videoThumbnailStrip->SetCurrentFrame(m_currentVideoFrameNumber);
+
+    m_videoThumbnailJob = new VideoThumbnailJob(options,
+        [this, jobId](const VideoThumbnail& thumbnail)
+        {
+            wxThreadEvent* evt = new wxThreadEvent(wxEVT_VIDEO_THUMBNAIL);
+
+            evt->SetExtraLong(jobId);
+            evt->SetPayload(thumbnail);
+            QueueEvent(evt);
+        },
+        [this, jobId](const VideoThumbnailsResult& result)
+        {
+            wxThreadEvent* evt = new wxThreadEvent(wxEVT_VIDEO_THUMBNAILS_FINISHED);
+
+            evt->SetExtraLong(jobId);
+            evt->SetPayload(result);
+            QueueEvent(evt);
+        });
+
+    m_videoThumbnailJob->Start();
+    SetStatusText("Creating thumbnails...", 1);
+}
+
+void OpenCVFrame::DeleteVideoThumbnailJob()
+{
+    // cancels the job and waits for the thread to finish
+    wxDELETE(m_videoThumbnailJob);
+}
+
+bool OpenCVFrame::StartCameraCapture(Mode mode, const wxString& sourceName,
+                                     const wxString& address, const wxSize& resolution,
+                                     bool useMJPEG, long connectTimeoutMs)
+{
+    static std::atomic<unsigned long> lastRequestId{0};
+
+    std::shared_ptr<CameraOpenRequest> request = std::make_shared<CameraOpenRequest>();
+    CameraOpenThread*                  thread = nullptr;
+
+    Clear();
+
+    request->id = ++lastRequestId;
+    request->address = address;
+    request->resolution = resolution;
+    request->useMJPEG = useMJPEG;
+    request->timeout = connectTimeoutMs;
+    request->captureOptions = address.empty() ? m_webcamCaptureOptions : m_streamCaptureOptions;
+    request->eventSink = this;
+
+    thread = new CameraOpenThread(request);
+    if ( thread->Run() != wxTHREAD_NO_ERROR )
     {
-        Clear();
+        delete thread;
+        wxLogError("Could not create the thread needed to connect to the camera.");
         return false;
     }
 
+    m_cameraOpenRequest = request;
+    m_cameraOpenMode = mode;
+    m_cameraOpenSourceName = sourceName;
+    m_cameraOpenTimeout = connectTimeoutMs;
+    m_cameraOpenStopWatch.Start();
+    m_cameraOpenTimer.Start(100);
+
+    ShowCameraOpenStatus(true);
+
     return true;
 }
 
+void OpenCVFrame::CancelCameraOpen()
+{
+    if ( !m_cameraOpenRequest )
+        return;
+
+    {
+        wxCriticalSectionLocker locker(m_cameraOpenRequest->eventSinkCS);
+
+        m_cameraOpenRequest->eventSink = nullptr;
+    }
+
+    m_cameraOpenRequest.reset();
+    m_cameraOpenTimer.Stop();
+    m_cameraOpenMode = Empty;
+    m_cameraOpenSourceName.clear();
+
+    ShowCameraOpenStatus(false);
+}
+
+void OpenCVFrame::ResetPresentation()
+{
+    m_presentTimer.Stop();
+    wxDELETE(m_pendingCameraFrame);
+
+    m_framesPresented = 0;
+    m_framesSuperseded = 0;
+    m_bitmapPanel->SetPresentationStats(0, 0);
+
+    m_displayedMatBitmap.release();
+    m_fullConvertTime = 0.0;
+    m_updatedFraction = 0.0;
+    m_timeSaved = 0.0;
+    m_bitmapPanel->SetIncrementalUpdateStats(-1.0, 0.0);
+    m_bitmapPanel->SetProcessingStats(wxString());
+
+    if ( m_frameStatistics )
+        m_frameStatistics->Reset();
+    m_bitmapPanel->SetFrameStatistics(FrameStatistics());
+}
+
+void OpenCVFrame::UpdatePresentInterval()
+{
+    static const int defaultRefreshRate = 60;
+
+    const int displayIndex = wxDisplay::GetFromWindow(this);
+    int       refreshRate = 0;
+
+    if ( displayIndex != wxNOT_FOUND )
+        refreshRate = wxDisplay(displayIndex).GetCurrentMode().refresh;
+
+    // refresh rate is 0 when unknown
+    if ( refreshRate <= 0 )
+        refreshRate = defaultRefreshRate;
+
+    m_presentInterval = wxMax(1, 1000 / refreshRate);
+}
+
+void OpenCVFrame::QueueCameraFrame(CameraFrame* frame)
+{
+    // A newer frame supersedes the one still waiting,
+    // there is no point in converting and painting the older one.
+    if ( m_pendingCameraFrame )
+    {
+        delete m_pendingCameraFrame;
+        m_framesSuperseded++;
+    }
+
+    m_pendingCameraFrame = frame;
+    SchedulePresentation();
+}
+
+void OpenCVFrame::SchedulePresentation()
+{
+    // When presenting on idle, OnIdle() is called
+    // once the pending events have been processed.
+    if ( m_presentOnIdle || m_presentTimer.IsRunning() )
+        return;
+
+    // Wait at least 1 ms even when the interval has already passed,
+    // so that the frames already queued by the camera thread
+    // are processed (and superseded) first.
+    const long sinceLastPresent = m_presentStopWatch.Time();
+
+    m_presentTimer.StartOnce(static_cast<int>(wxMax(1L, m_presentInterval - sinceLastPresent)));
+}
+
+void OpenCVFrame::PresentPendingCameraFrame()
+{
+    if ( !m_pendingCameraFrame )
+        return;
+
+    CameraFrame* frame = m_pendingCameraFrame;
+
+    m_pendingCameraFrame = nullptr;
+    m_presentStopWatch.Start();
+
+    m_framesPresented++;
+    m_bitmapPanel->SetPresentationStats(m_framesPresented, m_framesSuperseded);
+    m_bitmapPanel->SetProcessingStats(GetProcessingStatsText());
+    UpdateFrameStatistics();
+    ShowCameraFrame(frame);
+}
+
+void OpenCVFrame::ShowCameraOpenStatus(bool show)
+{
+    if ( show )
+    {
+        m_cameraOpenStatusText->SetLabel(wxString::Format("Connecting to %s (%.1f s)...",
+            m_cameraOpenSourceName, m_cameraOpenStopWatch.Time() / 1000.));
+    }
+
+    m_cameraOpenStatusText->Show(show);
+    m_cameraOpenCancelButton->Show(show);
+    m_cameraOpenStatusText->GetContainingSizer()->Layout();
+}
+
+void OpenCVFrame::CreateProcessingChain()
+{
+    if ( !m_processingChain )
+    {
+        // Processed frames are queued as if they came directly from
+        // the camera thread, wxEVT_CAMERA_FRAME handler cannot tell the difference.
+        // Clear() waits for the frames to be delivered before changing the session ID.
+        m_processingChain = new FrameProcessingChain([this](FrameProcessingChain::Frame& processed)
+            {
+                CameraFrame*   frame = new CameraFrame;
+                wxThreadEvent* evt = new wxThreadEvent(wxEVT_CAMERA_FRAME);
+
+                frame->matBitmap = processed.matBitmap;
+                frame->timeGet = processed.timeGet;
+                frame->processingError = processed.errorMessage;
+                frame->sessionId = m_cameraSessionId;
+
+                evt->SetPayload(frame);
+                QueueEvent(evt);
+            });
+        UpdateProcessingStages();
+    }
+}
+
 bool OpenCVFrame::StartCameraThread()
 {
     DeleteCameraThread();
+    CreateProcessingChain();
+
+    if ( m_sharedFrameRing )
+        m_cameraThread = new SharedFrameRingThread(this, m_sharedFrameRing, m_cameraSessionId, m_processingChain);
+    else
+        m_cameraThread = new CameraThread(this, m_videoCapture, m_cameraSessionId, m_processingChain);
 
-    m_cameraThread = new CameraThread(this, m_videoCapture);
     if ( m_cameraThread->Run() != wxTHREAD_NO_ERROR )
     {
         wxDELETE(m_cameraThread);
@@ -357,40 +1205,91 @@ void OpenCVFrame::DeleteCameraThread()
 void OpenCVFrame::OnImage(wxCommandEvent&)
 {
     static wxString fileName;
+    static wxString rawLayout("1920x1080 8UC3");
 
     fileName = wxFileSelector("Select Bitmap Image", "", fileName, "",
-        "Image files (*.jpg;*.png;*.tga;*.bmp)|*.jpg;*.png;*.tga;*.bmp",
+        "Image files (*.jpg;*.png;*.tga;*.bmp;*.tif;*.tiff;*.pgm;*.ppm;*.pnm)|*.jpg;*.png;*.tga;*.bmp;*.tif;*.tiff;*.pgm;*.ppm;*.pnm"
+        "|Raw image files (*.raw)|*.raw",
         wxFD_OPEN | wxFD_FILE_MUST_EXIST, this);
 
     if ( fileName.empty() )
         return;
 
-    cv::Mat matBitmap;
+    const bool  isRaw = wxFileName(fileName).GetExt().IsSameAs("raw", false);
+    MappedImage mappedImage;
+    cv::Mat     matBitmap;
     wxStopWatch stopWatch;
-    long timeGet = 0, timeConvert = 0;
+    long        timeGet = 0;
+    wxString    errorMessage;
 
-    stopWatch.Start();
-    matBitmap = cv::imread(fileName.ToStdString(), cv::IMREAD_COLOR);
-    timeGet = stopWatch.Time();
+    if ( isRaw )
+    {
+        RawImageLayout layout;
+        wxString       layoutStr = wxGetTextFromUser("Layout (<width>x<height> <type>[ <row stride>[ <offset>]]),\n"
+                                                     "type being one of 8UC1, 8UC3, 8UC4, 16UC1, 16UC3, 32FC1, or 32FC3",
+                                                     "Raw Image Layout", rawLayout, this);
 
-    if ( matBitmap.empty() )
+        if ( layoutStr.empty() )
+            return;
+
+        if ( !layout.Parse(layoutStr) )
+        {
+            wxLogError("Invalid raw image layout '%s'.", layoutStr);
+            return;
+        }
+
+        rawLayout = layoutStr;
+
+        stopWatch.Start();
+        if ( !mappedImage.OpenRaw(fileName, layout, errorMessage) )
+        {
+            wxLogError("Could not load raw image '%s': %s", fileName, errorMessage);
+            return;
+        }
+        timeGet = stopWatch.Time();
+    }
+    else if ( MappedImage::IsSupportedFileName(fileName) )
     {
-        wxLogError("Could not read image '%s'.", fileName);
-        return;
+        // Large uncompressed images are not read and copied but mapped,
+        // the conversion then reads the pixels directly from the file cache.
+        // Variants MappedImage does not support (e.g., RLE-compressed BMP)
+        // are loaded with cv::imread() below.
+        stopWatch.Start();
+        if ( mappedImage.Open(fileName, errorMessage) )
+            timeGet = stopWatch.Time();
+        else
+            wxLogDebug("Could not map '%s' (%s), using cv::imread().", fileName, errorMessage);
     }
 
-    Clear();
+    if ( !mappedImage.IsOpened() )
+    {
+        stopWatch.Start();
+        // Load the image as is (e.g., grayscale, 16-bit, or with alpha),
+        // ConvertMatBitmapTowxBitmap() can handle most formats directly.
+        matBitmap = ReadImage(fileName);
+        timeGet = stopWatch.Time();
 
-    wxBitmap bitmap = ConvertMatToBitmap(matBitmap, timeConvert);
+        if ( matBitmap.empty() )
+        {
+            wxLogError("Could not read image '%s'.", fileName);
+            return;
+        }
+    }
+
+    Clear();
 
-    if ( !bitmap.IsOk())
+    // The bitmap is a copy, so the file can be unmapped after the conversion.
+    if ( !ShowMatBitmap(mappedImage.IsOpened() ? mappedImage.GetMat() : matBitmap, timeGet,
+                        mappedImage.GetConversionOptions()) )
     {
         wxLogError("Could not convert Mat to wxBitmap.", fileName);
         Clear();
         return;
     }
 
-    m_bitmapPanel->SetBitmap(bitmap, timeGet, timeConvert);
+    SetStatusText(wxString::Format("Loaded %s in %ld ms",
+                  mappedImage.IsOpened() ? "memory-mapped" : "with cv::imread()", timeGet), 1);
+
     m_propertiesButton->Enable();
     m_mode = Image;
     m_sourceName = fileName;
@@ -408,18 +1307,21 @@ void OpenCVFrame::OnVideo(wxCommandEvent&)
     if ( fileName.empty() )
         return;
 
-    cv::VideoCapture* cap = new cv::VideoCapture(fileName.ToStdString());
+    cv::VideoCapture* cap = new cv::VideoCapture;
     int               frameCount = 0;
 
-    if ( !cap->isOpened() )
+    if ( !OpenVideoCapture(*cap, fileName, m_streamCaptureOptions) )
     {
-        wxLogError("Could not read video '%s'.", fileName);
+        wxLogError("Could not read video '%s' with %s.", fileName, m_streamCaptureOptions.ToString());
         delete cap;
         Clear();
         return;
     }
 
+    Clear();
+
     m_videoCapture = cap;
+    m_videoCaptureOptions = m_streamCaptureOptions;
     m_mode = Video;
     m_sourceName = fileName;
     m_currentVideoFrameNumber = 0;
@@ -434,7 +1336,10 @@ void OpenCVFrame::OnVideo(wxCommandEvent&)
     m_videoSlider->Show();
     m_videoSlider->SetFocus();
 
+    StartVideoThumbnails();
+
     m_propertiesButton->Enable();
+    m_exportButton->Enable();
 }
 
 
@@ -461,14 +1366,7 @@ void OpenCVFrame::OnWebCam(wxCommandEvent&)
     useMJPEG = wxMessageBox("Press Yes to use MJPEG or No to use the default FourCC.\nMJPEG may be much faster, particularly at higher resolutions.",
         "WebCamera", wxYES_NO, this) == wxYES;
 
-    if ( StartCameraCapture(wxEmptyString, resolutions[resolutionIndex], useMJPEG) )
-    {
-        m_mode = WebCam;
-        m_sourceName = "Default WebCam";
-        UpdateFrameTitle();
-        m_propertiesButton->Enable();
-    }
-
+    StartCameraCapture(WebCam, "Default WebCam", wxEmptyString, resolutions[resolutionIndex], useMJPEG);
 }
 
 void OpenCVFrame::OnIPCamera(wxCommandEvent&)
@@ -481,13 +1379,87 @@ void OpenCVFrame::OnIPCamera(wxCommandEvent&)
     if ( address.empty() )
         return;
 
-    if ( StartCameraCapture(address) )
+    static long timeout = 10;
+
+    timeout = wxGetNumberFromUser("Give up connecting to the camera after the given number of seconds.",
+                                  "Timeout:", "IP camera", timeout, 1, 300, this);
+    if ( timeout == -1 )
+        return;
+
+    StartCameraCapture(IPCamera, address, address, wxSize(), false, timeout * 1000);
+}
+
+void OpenCVFrame::OnSharedMemory(wxCommandEvent&)
+{
+    static wxString name = "camera";
+
+    name = wxGetTextFromUser("Enter the name of the frame ring the producer created.",
+                             "Shared Memory", name, this);
+
+    if ( name.empty() )
+        return;
+
+    std::shared_ptr<SharedFrameRingConsumer> ring = std::make_shared<SharedFrameRingConsumer>();
+    std::string                              errorMessage;
+
+    if ( !ring->Open(name.ToStdString(), errorMessage) )
     {
-        m_mode = IPCamera;
-        m_sourceName = address;
-        UpdateFrameTitle();
-        m_propertiesButton->Enable();
+        wxLogError("Could not open frame ring '%s': %s", name, wxString(errorMessage));
+        return;
+    }
+
+    // Mat requires the row stride to be a multiple of the element size
+    const SharedFrameRingFormat& format = ring->GetFormat();
+
+    if ( GetwxBitmapDepthForMatBitmap(cv::Mat(1, 1, format.type)) == 0
+         || format.rowStride % CV_ELEM_SIZE1(format.type) != 0 )
+    {
+        wxLogError("Frame ring '%s' has unsupported format %s.", name, wxString(cv::typeToString(format.type)));
+        return;
+    }
+
+    // The consumer holds at most the number of slots minus two, so that
+    // the producer has always slots to write into. The frames held are
+    // those in the processing chain, one waiting for the presentation,
+    // and one queued to replace it. With fewer slots, the ring would
+    // stall as soon as the presentation fell behind.
+    static const unsigned long presentationHeldFrames = 2;
+    const unsigned long        slotCount = static_cast<unsigned long>(ring->GetSlotCount());
+
+    if ( slotCount < presentationHeldFrames + 2 )
+    {
+        wxLogError("Frame ring '%s' has %lu slots, at least %lu are needed.",
+                   name, slotCount, presentationHeldFrames + 2);
+        return;
     }
+
+    CreateProcessingChain();
+
+    const unsigned long processingHeldFrames =
+        static_cast<unsigned long>(m_processingChain->GetMaxFramesInFlight()) + presentationHeldFrames;
+
+    if ( m_processingChain->HasStages() && slotCount < processingHeldFrames + 2 )
+    {
+        wxLogWarning("Frame ring '%s' has %lu slots, so only %lu of its frames can be processed at once.\n"
+                     "Use a ring with %lu slots to process as many frames at once as the processing allows.",
+                     name, slotCount, slotCount - 2 - presentationHeldFrames, processingHeldFrames + 2);
+    }
+
+    Clear();
+
+    m_sharedFrameRing = ring;
+    UpdatePresentInterval();
+
+    if ( !StartCameraThread() )
+    {
+        Clear();
+        return;
+    }
+
+    m_mode = SharedMemory;
+    m_sourceName = name;
+    UpdateFrameTitle();
+    m_propertiesButton->Enable();
 }
 
 void OpenCVFrame::OnClear(wxCommandEvent&)
@@ -503,11 +1475,11 @@ void OpenCVFrame::OnProperties(wxCommandEvent&)
 
     if ( m_mode == Image )
     {
-        const wxBitmap& bmp = m_bitmapPanel->GetBitmap();
+        const wxSize bmpSize = m_bitmapPanel->GetBitmapSize();
 
-        wxCHECK_RET(bmp.IsOk(), "Invalid bitmap in m_bitmapPanel");
-        properties.push_back(wxString::Format("Width: %d", bmp.GetWidth()));
-        properties.push_back(wxString::Format("Height: %d", bmp.GetHeight()));
+        wxCHECK_RET(bmpSize != wxDefaultSize, "No bitmap in m_bitmapPanel");
+        properties.push_back(wxString::Format("Width: %d", bmpSize.GetWidth()));
+        properties.push_back(wxString::Format("Height: %d", bmpSize.GetHeight()));
     }
 
     if ( m_videoCapture )
@@ -519,6 +1491,12 @@ void OpenCVFrame::OnProperties(wxCommandEvent&)
                                   (char)((fourCCInt & 0XFF000000) >> 24), 0};
 
         properties.push_back(wxString::Format("Backend: %s", wxString(m_videoCapture->getBackendName())));
+        properties.push_back(wxString::Format("Opened with: %s", m_videoCaptureOptions.ToString()));
+
+        const wxArrayString reportedOptions = GetVideoCaptureReportedOptions(*m_videoCapture);
+
+        for ( const auto& option : reportedOptions )
+            properties.push_back(option);
 
         properties.push_back(wxString::Format("Width: %.0f", m_videoCapture->get(cv::CAP_PROP_FRAME_WIDTH)));
         properties.push_back(wxString::Format("Height: %0.f", m_videoCapture->get(cv::CAP_PROP_FRAME_HEIGHT)));
@@ -542,9 +1520,348 @@ void OpenCVFrame::OnProperties(wxCommandEvent&)
         }
     }
 
+    if ( m_sharedFrameRing )
+    {
+        const SharedFrameRingFormat& format = m_sharedFrameRing->GetFormat();
+
+        properties.push_back(wxString::Format("Width: %d", format.width));
+        properties.push_back(wxString::Format("Height: %d", format.height));
+        properties.push_back(wxString::Format("Type: %s", wxString(cv::typeToString(format.type))));
+        properties.push_back(wxString::Format("Row stride: %lu bytes", static_cast<unsigned long>(format.rowStride)));
+        properties.push_back(wxString::Format("Slots: %lu", static_cast<unsigned long>(m_sharedFrameRing->GetSlotCount())));
+        properties.push_back(wxString::Format("When full: %s",
+            m_sharedFrameRing->GetPolicy() == SharedFrameRingProducer::OverwriteOldest
+            ? "overwrite oldest" : "wait for consumer"));
+        properties.push_back(wxString::Format("Frames published: %llu",
+            static_cast<unsigned long long>(m_sharedFrameRing->GetFramesPublished())));
+        properties.push_back(wxString::Format("Frames overwritten unread: %llu",
+            static_cast<unsigned long long>(m_sharedFrameRing->GetFramesOverwritten())));
+        properties.push_back(wxString::Format("Frames dropped by producer: %llu",
+            static_cast<unsigned long long>(m_sharedFrameRing->GetFramesDropped())));
+        properties.push_back(wxString::Format("Frames skipped: %llu",
+            static_cast<unsigned long long>(m_sharedFrameRing->GetFramesSkipped())));
+        properties.push_back(wxString::Format("Frames held: %lu",
+            static_cast<unsigned long>(m_sharedFrameRing->GetHeldFrameCount())));
+    }
+
+    if ( m_mode == WebCam || m_mode == IPCamera || m_mode == SharedMemory )
+    {
+        properties.push_back(wxString::Format("Presentation: %s", m_presentOnIdle ? wxString("on idle")
+                                              : wxString::Format("every %ld ms", m_presentInterval)));
+        properties.push_back(wxString::Format("Frames presented: %lu", m_framesPresented));
+        properties.push_back(wxString::Format("Frames superseded: %lu", m_framesSuperseded));
+
+        const wxString processingStats = GetProcessingStatsText();
+
+        if ( !processingStats.empty() )
+        {
+            wxStringTokenizer tokenizer(processingStats, "\n");
+
+            while ( tokenizer.HasMoreTokens() )
+                properties.push_back(tokenizer.GetNextToken());
+        }
+
+        if ( m_frameStatistics )
+        {
+            FrameStatistics statistics;
+            unsigned long   publishCount = 0;
+
+            m_frameStatistics->GetPublished(statistics, publishCount);
+            properties.push_back(wxString::Format("Statistics: 1 of %dx%d pixels sampled, %lu frames",
+                m_frameStatistics->GetGridStep(), m_frameStatistics->GetGridStep(), statistics.frameCount));
+
+            wxStringTokenizer tokenizer(FormatFrameStatistics(statistics), "\n");
+
+            while ( tokenizer.HasMoreTokens() )
+                properties.push_back(tokenizer.GetNextToken());
+        }
+
+        if ( m_incrementalUpdate )
+        {
+            properties.push_back(wxString::Format("Tiles updated (last frame): %.1f %%", m_updatedFraction * 100.));
+            properties.push_back(wxString::Format("Time saved (last frame): %.2f ms", m_timeSaved));
+        }
+    }
+
     wxGetSingleChoice("Name: value", "Properties", properties, this);
 }
 
+void OpenCVFrame::UpdateProcessingStages()
+{
+    if ( !m_processingChain )
+        return;
+
+    const std::vector<FrameProcessingStage>& availableStages = GetAvailableProcessingStages();
+    std::vector<FrameProcessingStage>        stages;
+
+    // statistics are of the frames as the camera provides them
+    if ( m_frameStatistics )
+        stages.push_back(CreateFrameStatisticsStage(m_frameStatistics));
+
+    for ( const auto index : m_processingStageIndices )
+        stages.push_back(availableStages[index]);
+
+    m_processingChain->SetStages(stages);
+}
+
+wxString OpenCVFrame::GetProcessingStatsText() const
+{
+    if ( !m_processingChain || !m_processingChain->HasStages() )
+        return wxString();
+
+    const FrameProcessingChain::Stats stats = m_processingChain->GetStats();
+    wxString                          text;
+
+    text.Printf("Processing: %lu threads, %lu frames in flight, %lu dropped\n",
+        static_cast<unsigned long>(stats.workerCount), static_cast<unsigned long>(stats.framesInFlight),
+        stats.framesDropped);
+
+    for ( const auto& stage : stats.stages )
+    {
+        text += wxString::Format("  %s: %.2f ms (mean %.2f ms)\n",
+            stage.name, stage.lastTime, stage.GetMeanTime());
+    }
+
+    return text;
+}
+
+void OpenCVFrame::UpdateFrameStatistics()
+{
+    if ( !m_frameStatistics )
+        return;
+
+    FrameStatistics statistics;
+
+    if ( m_frameStatistics->GetPublished(statistics, m_frameStatisticsPublishCount) )
+        m_bitmapPanel->SetFrameStatistics(statistics);
+}
+
+void OpenCVFrame::OnCaptureOptions(wxCommandEvent&)
+{
+    // Webcams have their own options, as camera backends differ from
+    // those for files and streams and support neither decoder threads
+    // nor hardware acceleration, see VideoCaptureOptions.
+    wxArrayString choices;
+    int           selection = 0;
+
+    choices.push_back("Video files and streams (also IP cameras)");
+    choices.push_back("Webcams");
+    selection = wxGetSingleChoiceIndex("Select the sources to set the options for.",
+                                       "Capture Options", choices, 0, this);
+    if ( selection == -1 )
+        return;
+
+    const bool          forCameras = selection == 1;
+    VideoCaptureOptions options = forCameras ? m_webcamCaptureOptions : m_streamCaptureOptions;
+    std::vector<int>    backends = { cv::CAP_ANY };
+
+    for ( const int backend : GetAvailableVideoCaptureBackends(forCameras) )
+    {
+        if ( backend != cv::CAP_ANY )
+            backends.push_back(backend);
+    }
+
+    choices.clear();
+    selection = 0;
+    for ( size_t i = 0; i < backends.size(); ++i )
+    {
+        choices.push_back(GetVideoCaptureBackendName(backends[i]));
+        if ( backends[i] == options.backend )
+            selection = static_cast<int>(i);
+    }
+
+    selection = wxGetSingleChoiceIndex(forCameras ? "Select the backend for opening webcams."
+                                                  : "Select the backend for opening video files and streams.",
+                                       "Capture Options", choices, selection, this);
+    if ( selection == -1 )
+        return;
+
+    options.backend = backends[selection];
+
+#if VIDEOCAPTURE_HAS_THREAD_COUNT
+    if ( !forCameras )
+    {
+        static const int threadCounts[] = { VideoCaptureOptions::Default, 0, 1, 2, 4, 8, 16 };
+
+        choices.clear();
+        selection = 0;
+        for ( size_t i = 0; i < WXSIZEOF(threadCounts); ++i )
+        {
+            if ( threadCounts[i] == VideoCaptureOptions::Default )
+                choices.push_back("Backend default");
+            else if ( threadCounts[i] == 0 )
+                choices.push_back("All CPU cores");
+            else
+                choices.push_back(wxString::Format("%d", threadCounts[i]));
+
+            if ( threadCounts[i] == options.threadCount )
+                selection = static_cast<int>(i);
+        }
+
+        selection = wxGetSingleChoiceIndex("Select the number of decoder threads (FFmpeg backend only).",
+                                           "Capture Options", choices, selection, this);
+        if ( selection == -1 )
+            return;
+
+        options.threadCount = threadCounts[selection];
+    }
+#endif
+
+#if VIDEOCAPTURE_HAS_OPEN_PARAMS
+    if ( !forCameras )
+    {
+        static const int accelerations[] = { VideoCaptureOptions::Default, cv::VIDEO_ACCELERATION_NONE, cv::VIDEO_ACCELERATION_ANY };
+
+        choices.clear();
+        choices.push_back("Backend default");
+        choices.push_back("None");
+        choices.push_back("Any available");
+        selection = 0;
+        for ( size_t i = 0; i < WXSIZEOF(accelerations); ++i )
+        {
+            if ( accelerations[i] == options.hwAcceleration )
+                selection = static_cast<int>(i);
+        }
+
+        selection = wxGetSingleChoiceIndex("Select the hardware acceleration of decoding.",
+                                           "Capture Options", choices, selection, this);
+        if ( selection == -1 )
+            return;
+
+        options.hwAcceleration = accelerations[selection];
+    }
+#endif
+
+    const long bufferSize = wxGetNumberFromUser("Enter the number of frames the backend buffers,\n"
+                                                "1 for the lowest camera latency or 0 for the backend default.",
+                                                "Frames:", "Capture Options", options.bufferSize, 0, 100, this);
+    if ( bufferSize == -1 )
+        return;
+
+    options.bufferSize = static_cast<int>(bufferSize);
+
+    if ( forCameras )
+        m_webcamCaptureOptions = options;
+    else
+        m_streamCaptureOptions = options;
+
+    if ( m_videoCapture )
+        wxLogMessage("The options will be used the next time a video or camera is opened.");
+}
+
+void OpenCVFrame::OnProcessing(wxCommandEvent&)
+{
+    const std::vector<FrameProcessingStage>& availableStages = GetAvailableProcessingStages();
+    wxArrayString                            stageNames;
+    wxArrayInt                               selections = m_processingStageIndices;
+
+    for ( const auto& stage : availableStages )
+        stageNames.push_back(stage.name);
+
+    if ( wxGetSelectedChoices(selections,
+            "Select the processing applied to camera frames, in the listed order.\n"
+            "The frames are processed in parallel, on all available CPU cores.",
+            "Processing", stageNames, this) == -1 )
+    {
+        return;
+    }
+
+    m_processingStageIndices = selections;
+    UpdateProcessingStages();
+}
+
+void OpenCVFrame::OnExport(wxCommandEvent&)
+{
+    if ( m_videoExportJob )
+    {
+        m_videoExportJob->Cancel();
+        return;
+    }
+
+    wxCHECK_RET(m_mode == Video && m_videoCapture, "Export requires an opened video");
+
+    const long frameCount = static_cast<long>(m_videoCapture->get(cv::CAP_PROP_FRAME_COUNT));
+    VideoExportOptions options;
+    long               firstFrame = 0, lastFrame = 0;
+    wxString           fileName;
+
+    firstFrame = wxGetNumberFromUser("Enter the number of the first frame to export.",
+                                     "First frame:", "Export", m_currentVideoFrameNumber, 0, frameCount - 1, this);
+    if ( firstFrame == -1 )
+        return;
+
+    lastFrame = wxGetNumberFromUser("Enter the number of the last frame to export.",
+                                    "Last frame:", "Export", frameCount - 1, firstFrame, frameCount - 1, this);
+    if ( lastFrame == -1 )
+        return;
+
+    fileName = wxFileSelector("Export Video", "", "", "avi",
+        "AVI files (*.avi)|*.avi", wxFD_SAVE | wxFD_OVERWRITE_PROMPT, this);
+    if ( fileName.empty() )
+        return;
+
+    options.inputFileName = m_sourceName;
+    options.captureOptions = m_streamCaptureOptions;
+    options.outputFileName = fileName;
+    options.firstFrame = static_cast<int>(firstFrame);
+    options.lastFrame = static_cast<int>(lastFrame);
+
+    for ( const auto index : m_processingStageIndices )
+        options.stages.push_back(GetAvailableProcessingStages()[index]);
+
+    m_videoExportJob = new VideoExportJob(options, [this](const VideoExportProgress& progress)
+        {
+            wxThreadEvent* evt = new wxThreadEvent(wxEVT_VIDEO_EXPORT_PROGRESS);
+
+            evt->SetPayload(progress);
+            QueueEvent(evt);
+        });
+
+    wxString errorMessage;
+
+    if ( !m_videoExportJob->Start(errorMessage) )
+    {
+        wxDELETE(m_videoExportJob);
+        wxLogError("Could not export the video: %s", errorMessage);
+        return;
+    }
+
+    m_exportButton->SetLabel("Cancel E&xport");
+    SetStatusText("Exporting...");
+}
+
+void OpenCVFrame::OnVideoExportProgress(wxThreadEvent& evt)
+{
+    const VideoExportProgress progress = evt.GetPayload<VideoExportProgress>();
+
+    // a stray event from an already deleted job
+    if ( !m_videoExportJob )
+        return;
+
+    if ( !progress.finished )
+    {
+        SetStatusText(wxString::Format("Exporting: %d/%d frames (%.0f %%), %.1f fps, %.1f MB/s",
+            progress.framesWritten, progress.frameCount,
+            progress.framesWritten * 100. / progress.frameCount, progress.fps, progress.MBPerSec));
+        return;
+    }
+
+    wxDELETE(m_videoExportJob);
+    m_exportButton->SetLabel("E&xport...");
+    m_exportButton->Enable(m_mode == Video);
+
+    if ( !progress.errorMessage.empty() )
+    {
+        SetStatusText("Export failed.");
+        wxLogError("Could not export the video: %s", progress.errorMessage);
+        return;
+    }
+
+    SetStatusText(wxString::Format("Export %s: %d frames in %.1f s, %.1f fps, %.1f MB/s",
+        progress.cancelled ? "cancelled" : "finished", progress.framesWritten,
+        progress.elapsedMs / 1000., progress.fps, progress.MBPerSec));
+}
+
 void OpenCVFrame::OnVideoSetFrame(wxCommandEvent& evt)
 {
     wxCHECK_RET(m_videoCapture, "OnVideoSetFrame() called without valid VideoCapture");
@@ -558,32 +1875,191 @@ void OpenCVFrame::OnVideoSetFrame(wxCommandEvent& evt)
     ShowVideoFrame(m_currentVideoFrameNumber);
 }
 
+void OpenCVFrame::OnVideoThumbnailStrip(wxCommandEvent& evt)
+{
+    if ( m_mode != Video )
+        return;
+
+    m_videoSlider->SetValue(evt.GetInt());
+    OnVideoSetFrame(evt);
+}
+
+void OpenCVFrame::OnVideoThumbnail(wxThreadEvent& evt)
+{
+    // a stray event from an already deleted job
+    if ( evt.GetExtraLong() != m_videoThumbnailJobId || !m_videoThumbnailJob )
+        return;
+
+    const VideoThumbnail thumbnail = evt.GetPayload<VideoThumbnail>();
+    wxImage              image(thumbnail.matBitmap.cols, thumbnail.matBitmap.rows, false);
+
+    if ( ConvertMatBitmapTowxImage(thumbnail.matBitmap, image) )
+        m_videoThumbnailStrip->SetThumbnail(thumbnail.index, image);
+}
+
+void OpenCVFrame::OnVideoThumbnailsFinished(wxThreadEvent& evt)
+{
+    if ( evt.GetExtraLong() != m_videoThumbnailJobId || !m_videoThumbnailJob )
+        return;
+
+    const VideoThumbnailsResult result = evt.GetPayload<VideoThumbnailsResult>();
+
+    DeleteVideoThumbnailJob();
+
+    if ( !result.errorMessage.empty() )
+    {
+        SetStatusText("Could not create thumbnails.", 1);
+        wxLogError("%s", result.errorMessage);
+        return;
+    }
+
+    SetStatusText(wxString::Format("%d thumbnails %s in %.0f ms",
+        result.thumbnailCount, result.fromCache ? "loaded from cache" : "created", result.elapsedMs), 1);
+}
+
+void OpenCVFrame::OnCameraOpened(wxThreadEvent& evt)
+{
+    std::shared_ptr<CameraOpenThread::Result> result = evt.GetPayload<std::shared_ptr<CameraOpenThread::Result>>();
+
+    // The request may have been cancelled after the thread
+    // had already queued the event, just silently drop it.
+    if ( !m_cameraOpenRequest || m_cameraOpenRequest->id != result->requestId )
+        return;
+
+    const Mode                mode = m_cameraOpenMode;
+    const wxString            sourceName = m_cameraOpenSourceName;
+    const VideoCaptureOptions captureOptions = m_cameraOpenRequest->captureOptions;
+
+    CancelCameraOpen();
+
+    if ( !result->capture )
+    {
+        wxLogError("%s", result->errorMessage);
+        return;
+    }
+
+    m_videoCapture = result->capture.release();
+    m_videoCaptureOptions = captureOptions;
+
+    UpdatePresentInterval();
+
+    if ( !StartCameraThread() )
+    {
+        Clear();
+        return;
+    }
+
+    m_mode = mode;
+    m_sourceName = sourceName;
+    UpdateFrameTitle();
+    m_propertiesButton->Enable();
+}
+
+void OpenCVFrame::OnCameraOpenCancel(wxCommandEvent&)
+{
+    CancelCameraOpen();
+}
+
+void OpenCVFrame::OnCameraOpenTimer(wxTimerEvent&)
+{
+    if ( !m_cameraOpenRequest )
+        return;
+
+    if ( m_cameraOpenTimeout > 0 && m_cameraOpenStopWatch.Time() >= m_cameraOpenTimeout )
+    {
+        const wxString sourceName = m_cameraOpenSourceName;
+
+        CancelCameraOpen();
+        wxLogError("Could not connect to '%s' within %.1f s.", sourceName, m_cameraOpenTimeout / 1000.);
+        return;
+    }
+
+    ShowCameraOpenStatus(true);
+}
+
+void OpenCVFrame::OnPresentOnIdle(wxCommandEvent& evt)
+{
+    m_presentOnIdle = evt.IsChecked();
+
+    if ( m_presentOnIdle )
+        m_presentTimer.Stop();
+    else if ( m_pendingCameraFrame )
+        SchedulePresentation();
+}
+
+void OpenCVFrame::OnIncrementalUpdate(wxCommandEvent& evt)
+{
+    m_incrementalUpdate = evt.IsChecked();
+
+    if ( !m_incrementalUpdate )
+    {
+        m_displayedMatBitmap.release();
+        m_bitmapPanel->SetIncrementalUpdateStats(-1.0, 0.0);
+    }
+}
+
+void OpenCVFrame::OnStatistics(wxCommandEvent& evt)
+{
+    if ( evt.IsChecked() )
+    {
+        m_frameStatistics = std::make_shared<FrameStatisticsCollector>();
+        m_frameStatisticsPublishCount = 0;
+    }
+    else
+    {
+        // the stages of the frames in flight keep it alive
+        m_frameStatistics.reset();
+        m_bitmapPanel->SetFrameStatistics(FrameStatistics());
+    }
+
+    UpdateProcessingStages();
+}
+
+void OpenCVFrame::OnPresentTimer(wxTimerEvent&)
+{
+    PresentPendingCameraFrame();
+}
+
+void OpenCVFrame::OnIdle(wxIdleEvent& evt)
+{
+    evt.Skip();
+
+    if ( m_presentOnIdle )
+        PresentPendingCameraFrame();
+}
+
 void OpenCVFrame::OnCameraFrame(wxThreadEvent& evt)
 {
-    CameraThread::CameraFrame* frame = evt.GetPayload<CameraThread::CameraFrame*>();
+    CameraFrame* frame = evt.GetPayload<CameraFrame*>();
 
     // After deleting the camera thread we may still get a stray frame
-    // from yet unprocessed event, just silently drop it.
-    if ( m_mode != IPCamera && m_mode != WebCam )
+    // from yet unprocessed event, possibly when already showing
+    // another camera, just silently drop it.
+    if ( (m_mode != IPCamera && m_mode != WebCam && m_mode != SharedMemory)
+         || frame->sessionId != m_cameraSessionId )
     {
         delete frame;
         return;
     }
 
-    long     timeConvert = 0;
-    wxBitmap bitmap = ConvertMatToBitmap(frame->matBitmap, timeConvert);
-
-    if ( bitmap.IsOk() )
-        m_bitmapPanel->SetBitmap(bitmap, frame->timeGet, timeConvert);
-    else
-        m_bitmapPanel->SetBitmap(wxBitmap(), 0, 0);
+    // Do not flood the user with errors for every frame,
+    // turn off the processing instead.
+    if ( !frame->processingError.empty() && !m_processingStageIndices.empty() )
+    {
+        wxLogError("Processing turned off: %s", frame->processingError);
+        m_processingStageIndices.clear();
+        UpdateProcessingStages();
+    }
 
-    delete frame;
+    QueueCameraFrame(frame);
 }
 
 void OpenCVFrame::OnCameraEmpty(wxThreadEvent&)
 {
-    wxLogError("Connection to the camera lost.");
+    if ( m_mode == SharedMemory )
+        wxLogError("The producer closed frame ring '%s'.", m_sourceName);
+    else
+        wxLogError("Connection to the camera lost.");
 
     Clear();
 }
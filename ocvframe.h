@@ -11,11 +11,20 @@
 #ifndef OCVFRAME_H
 #define OCVFRAME_H
 
+#include <atomic>
+#include <memory>
+
 #include <wx/wx.h>
+#include <wx/timer.h>
+
+#include "convertmattowxbmp.h"
+#include "videocaptureoptions.h"
 
 // forward declarations
+class WXDLLIMPEXP_FWD_BASE wxThread;
 class WXDLLIMPEXP_FWD_CORE wxSlider;
 class wxBitmapFromOpenCVPanel;
+class wxVideoThumbnailStrip;
 
 namespace cv
 {
@@ -23,11 +32,18 @@ namespace cv
     class VideoCapture;
 }
 
-class CameraThread;
+class FrameProcessingChain;
+class FrameStatisticsCollector;
+class SharedFrameRingConsumer;
+class VideoExportJob;
+class VideoThumbnailJob;
+struct CameraFrame;
+struct CameraOpenRequest;
 
 
 // This class can open an OpenCV source of images (image file, video file,
-// default WebCam, and IP camera) and display the images using wxBitmapFromOpenCVPanel.
+// default WebCam, and IP camera) or a shared-memory frame ring written
+// by another process and display the images using wxBitmapFromOpenCVPanel.
 class OpenCVFrame : public wxFrame
 {
 public:
@@ -41,6 +57,7 @@ private:
         Video,
         WebCam,
         IPCamera,
+        SharedMemory,
     };
 
     Mode                     m_mode{Empty};
@@ -48,24 +65,125 @@ private:
     int                      m_currentVideoFrameNumber{0};
 
     cv::VideoCapture*        m_videoCapture{nullptr};
-    CameraThread*            m_cameraThread{nullptr};
+    // used for opening the next video file or stream, including IP camera
+    VideoCaptureOptions      m_streamCaptureOptions;
+    // used for opening the next webcam, only backend and bufferSize
+    VideoCaptureOptions      m_webcamCaptureOptions;
+    // m_videoCapture was opened with
+    VideoCaptureOptions      m_videoCaptureOptions;
+    // frames of SharedMemory mode, shared with the Mats wrapping them
+    std::shared_ptr<SharedFrameRingConsumer> m_sharedFrameRing;
+    // retrieves frames from m_videoCapture or m_sharedFrameRing
+    wxThread*                m_cameraThread{nullptr};
+    // Changed by Clear(), frames of the previous camera sessions
+    // (e.g., in events not yet processed) are recognized by it.
+    // Read by the processing chain workers.
+    std::atomic<unsigned long> m_cameraSessionId{0};
+
+    // Camera frames are passed through it before they are displayed
+    // when it has any stages, it is created with the first camera thread.
+    FrameProcessingChain*    m_processingChain{nullptr};
+    wxArrayInt               m_processingStageIndices; // see GetAvailableProcessingStages()
+
+    // When not nullptr, statistics of the camera frames are computed
+    // by the first stage of m_processingChain and shown in m_bitmapPanel.
+    std::shared_ptr<FrameStatisticsCollector> m_frameStatistics;
+    unsigned long            m_frameStatisticsPublishCount{0};
+
+    // Exports a range of the opened video, runs in the background.
+    VideoExportJob*          m_videoExportJob{nullptr};
+
+    // Creates thumbnails of the opened video in the background,
+    // the ID identifies its events.
+    VideoThumbnailJob*       m_videoThumbnailJob{nullptr};
+    long                     m_videoThumbnailJobId{0};
+
+    // camera being opened, shared with the thread opening it
+    std::shared_ptr<CameraOpenRequest> m_cameraOpenRequest;
+    Mode                     m_cameraOpenMode{Empty};
+    wxString                 m_cameraOpenSourceName;
+    long                     m_cameraOpenTimeout{0};
+    wxTimer                  m_cameraOpenTimer;
+    wxStopWatch              m_cameraOpenStopWatch;
+
+    // Camera frames are not presented as soon as they arrive but
+    // at most once per display refresh (or when idle), only the newest
+    // frame is kept, the older ones are dropped before conversion.
+    CameraFrame*             m_pendingCameraFrame{nullptr};
+    bool                     m_presentOnIdle{false};
+    long                     m_presentInterval{16}; // ms
+    wxTimer                  m_presentTimer;
+    wxStopWatch              m_presentStopWatch;  // time since the last presentation
+    unsigned long            m_framesPresented{0};
+    unsigned long            m_framesSuperseded{0};
+
+    // When m_incrementalUpdate is true, a camera frame is compared
+    // to the displayed content and only the changed tiles are converted
+    // and repainted. m_displayedMatBitmap is a copy of what is displayed,
+    // comparing to the previous frame instead would let slow changes
+    // below the threshold accumulate without ever being repainted.
+    bool                     m_incrementalUpdate{false};
+    cv::Mat                  m_displayedMatBitmap;
+    double                   m_fullConvertTime{0.0}; // ms, of the last full conversion
+    double                   m_updatedFraction{0.0};
+    double                   m_timeSaved{0.0};       // ms, for the last frame
 
     wxBitmapFromOpenCVPanel* m_bitmapPanel;
     wxSlider*                m_videoSlider;
+    wxVideoThumbnailStrip*   m_videoThumbnailStrip;
     wxButton*                m_propertiesButton;
+    wxButton*                m_exportButton;
+    wxStaticText*            m_cameraOpenStatusText;
+    wxButton*                m_cameraOpenCancelButton;
+
+    static wxBitmap ConvertMatToBitmap(const cv::Mat& matBitmap, long& timeConvert,
+                                       const MatBitmapConversionOptions& options = MatBitmapConversionOptions());
 
-    static wxBitmap ConvertMatToBitmap(const cv::Mat& matBitmap, long& timeConvert);
+    // Converts matBitmap and displays it in m_bitmapPanel,
+    // on wxGTK3 via a cairo surface instead of wxBitmap.
+    bool ShowMatBitmap(const cv::Mat& matBitmap, long timeGet,
+                       const MatBitmapConversionOptions& options = MatBitmapConversionOptions());
+
+    // Converts and repaints only the tiles of matBitmap which differ
+    // from m_displayedMatBitmap and copies them into it.
+    // Returns false if it was not possible.
+    bool ShowMatBitmapTiles(const cv::Mat& matBitmap, long timeGet);
+
+    // Takes ownership of the frame.
+    void ShowCameraFrame(CameraFrame* frame);
 
     void Clear();
     void UpdateFrameTitle();
 
     void ShowVideoFrame(int frameNumber);
 
+    void StartVideoThumbnails();
+    void DeleteVideoThumbnailJob();
+
+    // The camera is opened asynchronously, in a worker thread,
+    // mode and sourceName are set only once it has been opened.
     // If address is empty, the default webcam is used.
     // resolution and useMJPEG are used only for webcam.
-    bool StartCameraCapture(const wxString& address,
+    // If the camera is not opened within connectTimeoutMs,
+    // the attempt is cancelled. m_webcamCaptureOptions are used
+    // for webcam and m_streamCaptureOptions for IP camera.
+    bool StartCameraCapture(Mode mode, const wxString& sourceName,
+                            const wxString& address,
                             const wxSize& resolution = wxSize(),
-                            bool useMJPEG = false);
+                            bool useMJPEG = false,
+                            long connectTimeoutMs = 10000);
+    void CancelCameraOpen();
+    void ResetPresentation();
+    void UpdatePresentInterval();
+    void QueueCameraFrame(CameraFrame* frame);
+    void SchedulePresentation();
+    void PresentPendingCameraFrame();
+    void ShowCameraOpenStatus(bool show);
+    void UpdateProcessingStages();
+    wxString GetProcessingStatsText() const;
+    // passes the statistics to m_bitmapPanel if new ones were published
+    void UpdateFrameStatistics();
+    void CreateProcessingChain();
     bool StartCameraThread();
     void DeleteCameraThread();
 
@@ -73,11 +191,29 @@ private:
     void OnVideo(wxCommandEvent&);
     void OnWebCam(wxCommandEvent&);
     void OnIPCamera(wxCommandEvent&);
+    void OnSharedMemory(wxCommandEvent&);
     void OnClear(wxCommandEvent&);
 
     void OnProperties(wxCommandEvent&);
+    void OnCaptureOptions(wxCommandEvent&);
+    void OnProcessing(wxCommandEvent&);
+    void OnExport(wxCommandEvent&);
+    void OnVideoExportProgress(wxThreadEvent& evt);
 
     void OnVideoSetFrame(wxCommandEvent& evt);
+    void OnVideoThumbnailStrip(wxCommandEvent& evt);
+    void OnVideoThumbnail(wxThreadEvent& evt);
+    void OnVideoThumbnailsFinished(wxThreadEvent& evt);
+
+    void OnCameraOpened(wxThreadEvent& evt);
+    void OnCameraOpenCancel(wxCommandEvent&);
+    void OnCameraOpenTimer(wxTimerEvent&);
+
+    void OnPresentOnIdle(wxCommandEvent& evt);
+    void OnIncrementalUpdate(wxCommandEvent& evt);
+    void OnStatistics(wxCommandEvent& evt);
+    void OnPresentTimer(wxTimerEvent&);
+    void OnIdle(wxIdleEvent& evt);
 
     void OnCameraFrame(wxThreadEvent& evt);
     void OnCameraEmpty(wxThreadEvent&);
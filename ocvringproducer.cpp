@@ -0,0 +1,150 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        ocvringproducer.cpp
+// Purpose:     Writes test frames into a shared-memory frame ring
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+// A command line program showing how a capture or analysis process
+// can pass its frames to the viewer with SharedFrameRingProducer.
+// It draws a moving test pattern with the frame number straight
+// into the ring, at the given frame rate (0 means as fast as possible),
+// and prints the throughput and the numbers of frames overwritten
+// unread or dropped every second.
+//
+// Usage: wxTestOpenCVProducer <name> [<width> <height> [<fps> [<slots> [wait]]]]
+// Then click "Shared Memory..." in the viewer and enter the name.
+// With "wait", the producer waits for the viewer when the ring is full
+// instead of overwriting the oldest frame.
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+
+#include "sharedframering.h"
+
+namespace {
+
+volatile sig_atomic_t stopRequested = 0;
+
+void OnSignal(int)
+{
+    stopRequested = 1;
+}
+
+void DrawTestFrame(cv::Mat& frame, uint64_t frameNumber)
+{
+    const int x = static_cast<int>((frameNumber * 8) % frame.cols);
+
+    frame.setTo(cv::Scalar(64, 128, 192));
+    cv::rectangle(frame, cv::Rect(x, 0, frame.cols / 16, frame.rows), cv::Scalar(255, 255, 255), cv::FILLED);
+    cv::putText(frame, std::to_string(frameNumber), cv::Point(frame.cols / 20, frame.rows / 2),
+                cv::FONT_HERSHEY_SIMPLEX, frame.rows / 200., cv::Scalar(0, 0, 0), frame.rows / 100 + 1);
+}
+
+} // unnamed namespace
+
+int main(int argc, char** argv)
+{
+    if ( argc < 2 || argc == 3 || argc > 7 )
+    {
+        fprintf(stderr, "Usage: %s <name> [<width> <height> [<fps> [<slots> [wait]]]]\n", argv[0]);
+        return 1;
+    }
+
+    const std::string name = argv[1];
+    const int         width = argc > 3 ? atoi(argv[2]) : 1920;
+    const int         height = argc > 3 ? atoi(argv[3]) : 1080;
+    const double      fps = argc > 4 ? atof(argv[4]) : 30.;
+    const int         slotCount = argc > 5 ? atoi(argv[5]) : 4;
+    const bool        wait = argc > 6 && strcmp(argv[6], "wait") == 0;
+
+    if ( width < 1 || height < 1 || fps < 0. )
+    {
+        fprintf(stderr, "Invalid frame size or rate.\n");
+        return 1;
+    }
+
+    SharedFrameRingProducer producer;
+    SharedFrameRingFormat   format;
+    std::string             errorMessage;
+
+    format.width = width;
+    format.height = height;
+    format.type = CV_8UC3;
+
+    if ( !producer.Create(name, format, slotCount,
+                          wait ? SharedFrameRingProducer::WaitForConsumer : SharedFrameRingProducer::OverwriteOldest,
+                          errorMessage) )
+    {
+        fprintf(stderr, "Could not create frame ring: %s\n", errorMessage.c_str());
+        return 1;
+    }
+
+    signal(SIGINT, OnSignal);
+    signal(SIGTERM, OnSignal);
+
+    printf("Writing %dx%d frames into ring '%s' with %d slots, press Ctrl+C to stop.\n",
+           width, height, name.c_str(), slotCount);
+
+    typedef std::chrono::steady_clock Clock;
+
+    const Clock::duration frameInterval = fps > 0.
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1. / fps))
+        : Clock::duration::zero();
+    Clock::time_point     nextFrameTime = Clock::now();
+    Clock::time_point     reportTime = nextFrameTime + std::chrono::seconds(1);
+    uint64_t              frameNumber = 0, reportedPublished = 0;
+
+    while ( !stopRequested )
+    {
+        // the frame is drawn straight into the shared memory, without a copy
+        void* buffer = producer.BeginWrite(100);
+
+        if ( buffer )
+        {
+            cv::Mat frame(format.height, format.width, format.type, buffer, producer.GetFormat().rowStride);
+
+            DrawTestFrame(frame, frameNumber);
+            producer.EndWrite();
+        }
+        ++frameNumber;
+
+        const Clock::time_point now = Clock::now();
+
+        if ( now >= reportTime )
+        {
+            const uint64_t published = producer.GetFramesPublished();
+
+            printf("%llu fps, published %llu, overwritten %llu, dropped %llu\n",
+                   static_cast<unsigned long long>(published - reportedPublished),
+                   static_cast<unsigned long long>(published),
+                   static_cast<unsigned long long>(producer.GetFramesOverwritten()),
+                   static_cast<unsigned long long>(producer.GetFramesDropped()));
+            reportedPublished = published;
+            reportTime += std::chrono::seconds(1);
+        }
+
+        if ( frameInterval != Clock::duration::zero() )
+        {
+            nextFrameTime += frameInterval;
+            if ( nextFrameTime > now )
+                std::this_thread::sleep_until(nextFrameTime);
+            else
+                nextFrameTime = now; // do not try to catch up
+        }
+    }
+
+    producer.Close();
+
+    return 0;
+}
@@ -0,0 +1,667 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        sharedframering.cpp
+// Purpose:     Passes frames between processes in shared memory
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <new>
+#include <thread>
+
+#ifdef _WIN32
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+#include "sharedframering.h"
+
+namespace
+{
+
+const uint32_t RingMagic   = 0x474E5257; // "WRNG"
+const uint32_t RingVersion = 1;
+
+// frame buffers start at page boundaries
+const size_t   RingAlignment = 4096;
+
+enum SlotState
+{
+    SlotFree      = 0,
+    SlotWriting   = 1,
+    SlotPublished = 2,
+    SlotHeld      = 3,
+};
+
+uint64_t MakeSlotState(uint64_t sequence, SlotState state)
+{
+    return (sequence << 2) | state;
+}
+
+SlotState GetSlotState(uint64_t slotState)
+{
+    return static_cast<SlotState>(slotState & 3);
+}
+
+uint64_t GetSlotSequence(uint64_t slotState)
+{
+    return slotState >> 2;
+}
+
+const uint64_t MaxSlotCount = 0xFFFF;
+
+uint64_t MakeNewestFrame(uint64_t sequence, size_t slotIndex)
+{
+    return ((sequence + 1) << 16) | slotIndex;
+}
+
+size_t AlignSize(size_t size)
+{
+    return (size + RingAlignment - 1) / RingAlignment * RingAlignment;
+}
+
+// The atomics are shared between processes, which works only
+// when they are lock-free, i.e., do not use a process-local lock.
+bool AreAtomicsLockFree(const SharedFrameRingHeader* header, std::string& errorMessage)
+{
+    if ( header->framesPublished.is_lock_free() && header->magic.is_lock_free() )
+        return true;
+
+    errorMessage = "64-bit atomic operations are not lock-free on this platform.";
+    return false;
+}
+
+#ifdef _WIN32
+
+std::wstring GetMappingName(const std::string& name)
+{
+    const std::string fullName = "Local\\wxOpenCVFrameRing-" + name;
+    std::wstring      wideName(fullName.size(), L'\0');
+
+    wideName.resize(::MultiByteToWideChar(CP_UTF8, 0, fullName.c_str(), static_cast<int>(fullName.size()),
+                                          &wideName[0], static_cast<int>(wideName.size())));
+    return wideName;
+}
+
+#else
+
+// POSIX shared memory names start with a slash and contain no other.
+std::string GetMappingName(const std::string& name)
+{
+    return "/wxOpenCVFrameRing-" + name;
+}
+
+// Returns true if the existing shared memory mappingName is not a ring
+// in use, i.e., its producer closed it or it does not have a valid header
+// (e.g., the producer crashed while creating it or it is not a ring at all).
+bool IsStaleRing(const std::string& mappingName)
+{
+    const int file = shm_open(mappingName.c_str(), O_RDONLY, 0);
+
+    // it was removed in the meantime
+    if ( file == -1 )
+        return true;
+
+    struct stat fileStat;
+    void*       memory = MAP_FAILED;
+
+    if ( fstat(file, &fileStat) == 0
+         && static_cast<size_t>(fileStat.st_size) >= sizeof(SharedFrameRingHeader) )
+    {
+        memory = mmap(nullptr, sizeof(SharedFrameRingHeader), PROT_READ, MAP_SHARED, file, 0);
+    }
+
+    close(file);
+
+    if ( memory == MAP_FAILED )
+        return true;
+
+    const SharedFrameRingHeader* header = static_cast<const SharedFrameRingHeader*>(memory);
+    const bool                   isStale = header->magic.load(std::memory_order_acquire) != RingMagic
+                                           || header->version != RingVersion
+                                           || header->producerClosed.load(std::memory_order_acquire) != 0;
+
+    munmap(memory, sizeof(SharedFrameRingHeader));
+
+    return isStale;
+}
+
+#endif // #ifdef _WIN32
+
+} // unnamed namespace
+
+size_t GetSharedFrameRingPixelSize(int type)
+{
+    static const size_t depthSizes[] = { 1, 1, 2, 2, 4, 4, 8, 2 };
+
+    return depthSizes[type & 7] * (((type >> 3) & 511) + 1);
+}
+
+uint64_t GetSharedFrameRingTimeNs()
+{
+    // steady_clock uses CLOCK_MONOTONIC on Linux, QueryPerformanceCounter()
+    // on MSW, and mach_absolute_time() on macOS, all of them system-wide.
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+//
+// SharedFrameRingProducer
+//
+
+SharedFrameRingProducer::~SharedFrameRingProducer()
+{
+    Close();
+}
+
+bool SharedFrameRingProducer::Create(const std::string& name, const SharedFrameRingFormat& format,
+                                     size_t slotCount, FullPolicy policy, std::string& errorMessage)
+{
+    Close();
+
+    if ( name.empty() || name.find_first_of("/\\") != std::string::npos )
+    {
+        errorMessage = "Invalid ring name.";
+        return false;
+    }
+
+    const size_t pixelSize = GetSharedFrameRingPixelSize(format.type);
+    const size_t rowSize = static_cast<size_t>(format.width) * pixelSize;
+
+    if ( format.width <= 0 || format.height <= 0 || slotCount < 2 || slotCount > MaxSlotCount
+         || (format.rowStride != 0 && format.rowStride < rowSize) )
+    {
+        errorMessage = "Invalid frame format or number of slots.";
+        return false;
+    }
+
+    m_format = format;
+    if ( m_format.rowStride == 0 )
+        m_format.rowStride = rowSize;
+
+    const size_t slotSize = AlignSize(m_format.rowStride * format.height);
+    const size_t dataOffset = AlignSize(sizeof(SharedFrameRingHeader) + slotCount * sizeof(SharedFrameRingSlot));
+    const size_t size = dataOffset + slotCount * slotSize;
+
+#ifdef _WIN32
+    const ULONGLONG mappingSize = size;
+    HANDLE          mapping = ::CreateFileMappingW(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+                                                   static_cast<DWORD>(mappingSize >> 32),
+                                                   static_cast<DWORD>(mappingSize & 0xFFFFFFFF),
+                                                   GetMappingName(name).c_str());
+
+    if ( mapping && ::GetLastError() == ERROR_ALREADY_EXISTS )
+    {
+        ::CloseHandle(mapping);
+        errorMessage = "A ring with the same name already exists.";
+        return false;
+    }
+
+    if ( !mapping )
+    {
+        errorMessage = "Could not create the shared memory.";
+        return false;
+    }
+
+    m_memory = ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if ( !m_memory )
+    {
+        ::CloseHandle(mapping);
+        errorMessage = "Could not map the shared memory.";
+        return false;
+    }
+
+    m_handle = mapping;
+#else
+    const std::string mappingName = GetMappingName(name);
+    int               file = shm_open(mappingName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+    // Unlike on MSW, the memory outlives all the processes using it
+    // until it is unlinked, so a stale one is replaced, but not a ring
+    // of a running producer, the consumers could then open the wrong one.
+    if ( file == -1 && errno == EEXIST )
+    {
+        if ( !IsStaleRing(mappingName) )
+        {
+            errorMessage = "A ring with the same name already exists.";
+            return false;
+        }
+
+        shm_unlink(mappingName.c_str());
+        file = shm_open(mappingName.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    }
+
+    if ( file == -1 )
+    {
+        errorMessage = errno == EEXIST ? "A ring with the same name already exists."
+                                       : "Could not create the shared memory.";
+        return false;
+    }
+
+    if ( ftruncate(file, static_cast<off_t>(size)) != 0 )
+    {
+        close(file);
+        shm_unlink(mappingName.c_str());
+        errorMessage = "Could not allocate the shared memory.";
+        return false;
+    }
+
+    void* memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+
+    close(file);
+
+    if ( memory == MAP_FAILED )
+    {
+        shm_unlink(mappingName.c_str());
+        errorMessage = "Could not map the shared memory.";
+        return false;
+    }
+
+    m_memory = memory;
+#endif // #ifdef _WIN32
+
+    m_name = name;
+    m_size = size;
+    m_policy = policy;
+    m_nextSequence = 0;
+    m_nextSlot = 0;
+    m_writing = false;
+
+    // The memory is zeroed, i.e., all slots are free with sequence 0.
+    m_header = new (m_memory) SharedFrameRingHeader();
+    m_slots = reinterpret_cast<SharedFrameRingSlot*>(static_cast<char*>(m_memory) + sizeof(SharedFrameRingHeader));
+
+    if ( !AreAtomicsLockFree(m_header, errorMessage) )
+    {
+        Close();
+        return false;
+    }
+
+    for ( size_t i = 0; i < slotCount; ++i )
+        new (&m_slots[i]) SharedFrameRingSlot();
+
+    m_header->version = RingVersion;
+    m_header->slotCount = static_cast<uint32_t>(slotCount);
+    m_header->policy = policy;
+    m_header->width = format.width;
+    m_header->height = format.height;
+    m_header->type = format.type;
+    m_header->rowStride = m_format.rowStride;
+    m_header->slotSize = slotSize;
+    m_header->dataOffset = dataOffset;
+    // the consumer does not use the ring until it sees the magic
+    m_header->magic.store(RingMagic, std::memory_order_release);
+
+    return true;
+}
+
+void SharedFrameRingProducer::Close()
+{
+    if ( !m_memory )
+        return;
+
+    if ( m_header )
+        m_header->producerClosed.store(1, std::memory_order_release);
+
+    // The consumer keeps its mapping, so it can release the frames
+    // it holds and find out the producer is gone.
+#ifdef _WIN32
+    ::UnmapViewOfFile(m_memory);
+    ::CloseHandle(static_cast<HANDLE>(m_handle));
+    m_handle = nullptr;
+#else
+    munmap(m_memory, m_size);
+    shm_unlink(GetMappingName(m_name).c_str());
+#endif
+
+    m_memory = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_slots = nullptr;
+    m_name.clear();
+}
+
+void* SharedFrameRingProducer::BeginWrite(long timeoutMs)
+{
+    if ( !m_header || m_writing )
+        return nullptr;
+
+    const auto   start = std::chrono::steady_clock::now();
+    const size_t slotCount = m_header->slotCount;
+
+    for ( ;; )
+    {
+        // Round-robin, i.e., starting with the slot with the oldest frame.
+        // The slots the consumer holds are skipped and, with WaitForConsumer,
+        // also those with frames the consumer has not read yet.
+        for ( size_t i = 0; i < slotCount; ++i )
+        {
+            const size_t         slotIndex = (m_nextSlot + i) % slotCount;
+            SharedFrameRingSlot& slot = m_slots[slotIndex];
+            uint64_t             slotState = slot.state.load(std::memory_order_acquire);
+            const SlotState      state = GetSlotState(slotState);
+
+            if ( state != SlotFree && !(state == SlotPublished && m_policy == OverwriteOldest) )
+                continue;
+
+            // fails when the consumer has just acquired or skipped the frame
+            if ( !slot.state.compare_exchange_strong(slotState, MakeSlotState(m_nextSequence, SlotWriting),
+                                                     std::memory_order_acq_rel) )
+            {
+                continue;
+            }
+
+            if ( state == SlotPublished )
+                m_header->framesOverwritten.fetch_add(1, std::memory_order_relaxed);
+
+            m_writing = true;
+            m_writingSlot = slotIndex;
+            m_nextSlot = (slotIndex + 1) % slotCount;
+            return static_cast<char*>(m_memory) + m_header->dataOffset + slotIndex * m_header->slotSize;
+        }
+
+        // with OverwriteOldest, only the slots held by the consumer cannot be written
+        if ( m_policy == OverwriteOldest
+             || std::chrono::steady_clock::now() - start >= std::chrono::milliseconds(timeoutMs) )
+        {
+            break;
+        }
+
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+
+    m_header->framesDropped.fetch_add(1, std::memory_order_relaxed);
+    return nullptr;
+}
+
+void SharedFrameRingProducer::EndWrite()
+{
+    if ( !m_header || !m_writing )
+        return;
+
+    SharedFrameRingSlot& slot = m_slots[m_writingSlot];
+
+    slot.timestampNs = GetSharedFrameRingTimeNs();
+    slot.state.store(MakeSlotState(m_nextSequence, SlotPublished), std::memory_order_release);
+
+    m_writing = false;
+    m_header->newestFrame.store(MakeNewestFrame(m_nextSequence, m_writingSlot), std::memory_order_release);
+    m_header->framesPublished.store(++m_nextSequence, std::memory_order_release);
+}
+
+bool SharedFrameRingProducer::Write(const void* data, size_t rowStride, long timeoutMs)
+{
+    char* buffer = static_cast<char*>(BeginWrite(timeoutMs));
+
+    if ( !buffer )
+        return false;
+
+    const size_t rowSize = static_cast<size_t>(m_format.width) * GetSharedFrameRingPixelSize(m_format.type);
+
+    if ( rowStride == m_format.rowStride )
+    {
+        memcpy(buffer, data, rowStride * (m_format.height - 1) + rowSize);
+    }
+    else
+    {
+        for ( int row = 0; row < m_format.height; ++row )
+            memcpy(buffer + row * m_format.rowStride, static_cast<const char*>(data) + row * rowStride, rowSize);
+    }
+
+    EndWrite();
+    return true;
+}
+
+uint64_t SharedFrameRingProducer::GetFramesPublished() const
+{
+    return m_header ? m_header->framesPublished.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t SharedFrameRingProducer::GetFramesOverwritten() const
+{
+    return m_header ? m_header->framesOverwritten.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t SharedFrameRingProducer::GetFramesDropped() const
+{
+    return m_header ? m_header->framesDropped.load(std::memory_order_relaxed) : 0;
+}
+
+//
+// SharedFrameRingConsumer
+//
+
+SharedFrameRingConsumer::~SharedFrameRingConsumer()
+{
+    Close();
+}
+
+bool SharedFrameRingConsumer::Open(const std::string& name, std::string& errorMessage)
+{
+    Close();
+
+    if ( name.empty() || name.find_first_of("/\\") != std::string::npos )
+    {
+        errorMessage = "Invalid ring name.";
+        return false;
+    }
+
+#ifdef _WIN32
+    HANDLE mapping = ::OpenFileMappingW(FILE_MAP_ALL_ACCESS, FALSE, GetMappingName(name).c_str());
+
+    if ( !mapping )
+    {
+        errorMessage = "The ring does not exist, is the producer running?";
+        return false;
+    }
+
+    // the view keeps the mapping alive
+    m_memory = ::MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    ::CloseHandle(mapping);
+
+    MEMORY_BASIC_INFORMATION info;
+
+    if ( !m_memory || ::VirtualQuery(m_memory, &info, sizeof(info)) == 0 )
+    {
+        Close();
+        errorMessage = "Could not map the shared memory.";
+        return false;
+    }
+
+    m_size = info.RegionSize;
+#else
+    const int   file = shm_open(GetMappingName(name).c_str(), O_RDWR, 0);
+    struct stat fileStat;
+
+    if ( file == -1 )
+    {
+        errorMessage = "The ring does not exist, is the producer running?";
+        return false;
+    }
+
+    if ( fstat(file, &fileStat) != 0 || static_cast<size_t>(fileStat.st_size) < sizeof(SharedFrameRingHeader) )
+    {
+        close(file);
+        errorMessage = "The shared memory is not a frame ring.";
+        return false;
+    }
+
+    void* memory = mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+
+    close(file);
+
+    if ( memory == MAP_FAILED )
+    {
+        errorMessage = "Could not map the shared memory.";
+        return false;
+    }
+
+    m_memory = memory;
+    m_size = static_cast<size_t>(fileStat.st_size);
+#endif // #ifdef _WIN32
+
+    SharedFrameRingHeader* header = static_cast<SharedFrameRingHeader*>(m_memory);
+
+    if ( !AreAtomicsLockFree(header, errorMessage) )
+    {
+        Close();
+        return false;
+    }
+
+    if ( header->magic.load(std::memory_order_acquire) != RingMagic || header->version != RingVersion )
+    {
+        Close();
+        errorMessage = "The shared memory is not a frame ring of a supported version.";
+        return false;
+    }
+
+    const size_t pixelSize = GetSharedFrameRingPixelSize(header->type);
+
+    if ( header->slotCount < 2 || header->slotCount > MaxSlotCount || header->width <= 0 || header->height <= 0
+         || header->rowStride < static_cast<uint64_t>(header->width) * pixelSize
+         || header->slotSize < header->rowStride * header->height
+         || header->dataOffset < sizeof(SharedFrameRingHeader) + header->slotCount * sizeof(SharedFrameRingSlot)
+         || header->dataOffset + header->slotCount * header->slotSize > m_size )
+    {
+        Close();
+        errorMessage = "The frame ring header is corrupted.";
+        return false;
+    }
+
+    m_header = header;
+    m_slots = reinterpret_cast<SharedFrameRingSlot*>(static_cast<char*>(m_memory) + sizeof(SharedFrameRingHeader));
+    m_format.width = header->width;
+    m_format.height = header->height;
+    m_format.type = header->type;
+    m_format.rowStride = static_cast<size_t>(header->rowStride);
+    m_slotCount = header->slotCount;
+    m_maxHeldFrames = std::max<size_t>(1, m_slotCount - 2);
+    m_nextSequence = 0;
+    m_framesSkipped = 0;
+    m_heldFrameCount = 0;
+
+    return true;
+}
+
+void SharedFrameRingConsumer::Close()
+{
+    if ( !m_memory )
+        return;
+
+#ifdef _WIN32
+    ::UnmapViewOfFile(m_memory);
+#else
+    munmap(m_memory, m_size);
+#endif
+
+    m_memory = nullptr;
+    m_size = 0;
+    m_header = nullptr;
+    m_slots = nullptr;
+    m_format = SharedFrameRingFormat();
+    m_slotCount = 0;
+}
+
+SharedFrameRingProducer::FullPolicy SharedFrameRingConsumer::GetPolicy() const
+{
+    return m_header ? static_cast<SharedFrameRingProducer::FullPolicy>(m_header->policy)
+                    : SharedFrameRingProducer::OverwriteOldest;
+}
+
+bool SharedFrameRingConsumer::AcquireNewest(Frame& frame)
+{
+    if ( !m_header || m_heldFrameCount >= m_maxHeldFrames )
+        return false;
+
+    // A few attempts, the producer may be overwriting
+    // the newest frame with an even newer one.
+    for ( int attempt = 0; attempt < 4; ++attempt )
+    {
+        const uint64_t newestFrame = m_header->newestFrame.load(std::memory_order_acquire);
+
+        if ( newestFrame == 0 )
+            return false;
+
+        const uint64_t newest = (newestFrame >> 16) - 1;
+        const size_t   newestSlot = static_cast<size_t>(newestFrame & 0xFFFF);
+
+        if ( newest < m_nextSequence || newestSlot >= m_slotCount )
+            return false;
+
+        // Give the slots with older unread frames back to the producer,
+        // the compare-and-swap fails if the producer has just overwritten one.
+        for ( size_t i = 0; i < m_slotCount; ++i )
+        {
+            uint64_t slotState = m_slots[i].state.load(std::memory_order_acquire);
+
+            if ( GetSlotState(slotState) == SlotPublished && GetSlotSequence(slotState) < newest
+                 && m_slots[i].state.compare_exchange_strong(slotState,
+                        MakeSlotState(GetSlotSequence(slotState), SlotFree), std::memory_order_acq_rel) )
+            {
+                ++m_framesSkipped;
+            }
+        }
+
+        SharedFrameRingSlot& slot = m_slots[newestSlot];
+        uint64_t             expected = MakeSlotState(newest, SlotPublished);
+
+        if ( slot.state.compare_exchange_strong(expected, MakeSlotState(newest, SlotHeld), std::memory_order_acq_rel) )
+        {
+            frame.data = static_cast<const char*>(m_memory) + m_header->dataOffset + newestSlot * m_header->slotSize;
+            frame.sequence = newest;
+            frame.slotIndex = newestSlot;
+            frame.timestampNs = slot.timestampNs;
+
+            m_nextSequence = newest + 1;
+            ++m_heldFrameCount;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void SharedFrameRingConsumer::Release(const Frame& frame)
+{
+    if ( !m_header || !frame.data )
+        return;
+
+    // only the consumer changes the state of a held slot
+    m_slots[frame.slotIndex].state.store(MakeSlotState(frame.sequence, SlotFree), std::memory_order_release);
+    --m_heldFrameCount;
+}
+
+bool SharedFrameRingConsumer::IsProducerClosed() const
+{
+    return !m_header || m_header->producerClosed.load(std::memory_order_acquire) != 0;
+}
+
+uint64_t SharedFrameRingConsumer::GetFramesPublished() const
+{
+    return m_header ? m_header->framesPublished.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t SharedFrameRingConsumer::GetFramesOverwritten() const
+{
+    return m_header ? m_header->framesOverwritten.load(std::memory_order_relaxed) : 0;
+}
+
+uint64_t SharedFrameRingConsumer::GetFramesDropped() const
+{
+    return m_header ? m_header->framesDropped.load(std::memory_order_relaxed) : 0;
+}
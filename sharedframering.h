@@ -0,0 +1,241 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        sharedframering.h
+// Purpose:     Passes frames between processes in shared memory
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef SHAREDFRAMERING_H
+#define SHAREDFRAMERING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// This file and sharedframering.cpp form a small library for processes
+// producing frames (e.g., capture or analysis) to pass them to another
+// process (e.g., this viewer) without encoding or copying them through
+// a pipe or socket. It depends on neither wxWidgets nor OpenCV.
+
+/**
+    Describes the frames in a ring, all frames have the same format.
+*/
+struct SharedFrameRingFormat
+{
+    int      width{0};
+    int      height{0};
+    // OpenCV Mat type, e.g., CV_8UC3 (16). OpenCV is not needed
+    // to use the ring, its type encoding is used only to compute
+    // the pixel size: 1, 2, 4, or 8 bytes per channel (depth in
+    // bits 0-2), the number of channels minus one in bits 3-11.
+    int      type{0};
+    // Distance between the starts of two rows in bytes,
+    // 0 means width * pixel size.
+    size_t   rowStride{0};
+};
+
+// Returns the size of a single pixel of the given OpenCV Mat type in bytes.
+size_t GetSharedFrameRingPixelSize(int type);
+
+// Returns the time in nanoseconds of a monotonic clock common
+// to all processes on the computer, used for frame timestamps.
+uint64_t GetSharedFrameRingTimeNs();
+
+/**
+    The shared memory starts with this header, followed by slotCount
+    SharedFrameRingSlot structures and then slotCount frame buffers,
+    each slotSize bytes long, the first one at dataOffset.
+
+    The ring is lock-free and has a single producer and a single consumer.
+    Each slot has a state (free, being written, published, or held by the
+    consumer) combined with the sequence number of its frame into a single
+    atomic value, so that the producer and consumer can claim the slot
+    with a single compare-and-swap and the consumer never reads
+    a frame the producer is overwriting. The producer writes into
+    the slots round-robin, skipping those the consumer holds,
+    newestFrame tells the consumer which slot has the newest frame.
+*/
+struct alignas(64) SharedFrameRingHeader
+{
+    std::atomic<uint32_t> magic;      // set by the producer after everything else
+    uint32_t              version;
+    uint32_t              slotCount;
+    uint32_t              policy;     // SharedFrameRingProducer::FullPolicy
+    int32_t               width;
+    int32_t               height;
+    int32_t               type;
+    uint32_t              reserved;
+    uint64_t              rowStride;
+    uint64_t              slotSize;
+    uint64_t              dataOffset;
+
+    std::atomic<uint32_t> producerClosed;
+    // the number of frames published, i.e., also the sequence number of the next one
+    std::atomic<uint64_t> framesPublished;
+    // (sequence number + 1) << 16 | slot index of the newest frame, 0 before the first one
+    std::atomic<uint64_t> newestFrame;
+    // unread frames overwritten by newer ones (OverwriteOldest only)
+    std::atomic<uint64_t> framesOverwritten;
+    // frames not published at all, because there was no slot to write them into
+    std::atomic<uint64_t> framesDropped;
+};
+
+struct alignas(64) SharedFrameRingSlot
+{
+    // the sequence number of the frame shifted left by two bits, ORed with SlotState
+    std::atomic<uint64_t> state;
+    uint64_t              timestampNs; // when the frame was published, see GetSharedFrameRingTimeNs()
+};
+
+/**
+    Creates the ring and writes frames into it.
+
+    The producer never waits for the consumer to read a frame unless
+    WaitForConsumer is used, it is not even required that a consumer exists.
+    The producer and consumer can be started in any order, the consumer
+    only needs to be (re)started after the producer creates the ring.
+*/
+class SharedFrameRingProducer
+{
+public:
+    // What happens when all the slots the consumer does not hold
+    // contain frames the consumer has not read yet.
+    enum FullPolicy
+    {
+        // The oldest unread frame is replaced with the new one, the consumer
+        // always gets the newest frames (e.g., a live preview).
+        OverwriteOldest,
+        // BeginWrite() waits until the consumer reads or skips a frame,
+        // i.e., the consumer slows the producer down (backpressure).
+        WaitForConsumer,
+    };
+
+    SharedFrameRingProducer() {}
+    // Calls Close().
+    ~SharedFrameRingProducer();
+
+    // name is an identifier without slashes, e.g., "camera1".
+    // slotCount must be between 2 and 65535.
+    // Fails if a ring with the same name exists, unless its producer
+    // closed it or it does not have a valid header. On POSIX, the ring
+    // of a crashed producer is not removed automatically, it can be removed
+    // manually (on Linux, it is /dev/shm/wxOpenCVFrameRing-<name>).
+    bool Create(const std::string& name, const SharedFrameRingFormat& format,
+                size_t slotCount, FullPolicy policy, std::string& errorMessage);
+    // Tells the consumer no more frames will come and removes the ring.
+    void Close();
+
+    bool IsCreated() const { return m_header != nullptr; }
+
+    const SharedFrameRingFormat& GetFormat() const { return m_format; }
+
+    // Returns the buffer to write the next frame into, its rows must be
+    // GetFormat().rowStride bytes apart. Returns nullptr if the frame must be
+    // dropped, because the consumer holds all the slots or, with WaitForConsumer,
+    // no slot was freed by the consumer within timeoutMs. In any case,
+    // the drop is counted in the header.
+    void* BeginWrite(long timeoutMs = 0);
+    // Publishes the frame written to the buffer returned by BeginWrite().
+    void EndWrite();
+
+    // Copies the frame with rows rowStride bytes apart into the ring.
+    // Returns false if the frame was dropped, see BeginWrite().
+    bool Write(const void* data, size_t rowStride, long timeoutMs = 0);
+
+    uint64_t GetFramesPublished() const;
+    uint64_t GetFramesOverwritten() const;
+    uint64_t GetFramesDropped() const;
+
+private:
+    std::string            m_name;
+    SharedFrameRingFormat  m_format;
+    FullPolicy             m_policy{OverwriteOldest};
+    void*                  m_memory{nullptr};
+    size_t                 m_size{0};
+    void*                  m_handle{nullptr}; // MSW only, the mapping exists only while it is open
+    SharedFrameRingHeader* m_header{nullptr};
+    SharedFrameRingSlot*   m_slots{nullptr};
+    uint64_t               m_nextSequence{0};
+    size_t                 m_nextSlot{0};
+    size_t                 m_writingSlot{0};
+    bool                   m_writing{false};
+
+    SharedFrameRingProducer(const SharedFrameRingProducer&) = delete;
+    SharedFrameRingProducer& operator=(const SharedFrameRingProducer&) = delete;
+};
+
+/**
+    Opens an existing ring and reads frames from it.
+
+    The frames are not copied, the consumer gets pointers to them
+    in the shared memory, which stay valid until Release() is called.
+    Acquire and release can be called from different threads,
+    but only one thread can acquire the frames.
+*/
+class SharedFrameRingConsumer
+{
+public:
+    struct Frame
+    {
+        const void* data{nullptr};
+        uint64_t    sequence{0};    // 0 for the first frame published
+        uint64_t    timestampNs{0}; // see GetSharedFrameRingTimeNs()
+        size_t      slotIndex{0};
+    };
+
+    SharedFrameRingConsumer() {}
+    // Calls Close(), all frames must be released before.
+    ~SharedFrameRingConsumer();
+
+    bool Open(const std::string& name, std::string& errorMessage);
+    void Close();
+
+    bool IsOpened() const { return m_header != nullptr; }
+
+    const SharedFrameRingFormat& GetFormat() const { return m_format; }
+    size_t GetSlotCount() const { return m_slotCount; }
+    SharedFrameRingProducer::FullPolicy GetPolicy() const;
+
+    // At most maxHeldFrames can be held at the same time, so that
+    // the producer has always slots to write into. By default,
+    // it is the number of slots minus two.
+    void SetMaxHeldFrames(size_t maxHeldFrames) { m_maxHeldFrames = maxHeldFrames; }
+    size_t GetHeldFrameCount() const { return m_heldFrameCount; }
+
+    // Acquires the newest published frame not acquired yet. The older
+    // unread frames are skipped, i.e., their slots are given back
+    // to the producer. Returns false if there is no such frame
+    // or maxHeldFrames are already held.
+    bool AcquireNewest(Frame& frame);
+    // Gives the slot with the frame back to the producer.
+    void Release(const Frame& frame);
+
+    // Returns true after the producer has called Close().
+    bool IsProducerClosed() const;
+
+    uint64_t GetFramesPublished() const;
+    uint64_t GetFramesOverwritten() const;
+    uint64_t GetFramesDropped() const;
+    // frames the consumer did not acquire because newer ones were available
+    uint64_t GetFramesSkipped() const { return m_framesSkipped; }
+
+private:
+    SharedFrameRingFormat  m_format;
+    size_t                 m_slotCount{0};
+    void*                  m_memory{nullptr};
+    size_t                 m_size{0};
+    SharedFrameRingHeader* m_header{nullptr};
+    SharedFrameRingSlot*   m_slots{nullptr};
+    uint64_t               m_nextSequence{0};
+    uint64_t               m_framesSkipped{0};
+    size_t                 m_maxHeldFrames{0};
+    std::atomic<size_t>    m_heldFrameCount{0};
+
+    SharedFrameRingConsumer(const SharedFrameRingConsumer&) = delete;
+    SharedFrameRingConsumer& operator=(const SharedFrameRingConsumer&) = delete;
+};
+
+#endif // #ifndef SHAREDFRAMERING_H
@@ -0,0 +1,156 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        videocaptureoptions.cpp
+// Purpose:     Opens cv::VideoCapture with backend and decoder options
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <opencv2/videoio/registry.hpp>
+
+#include "videocaptureoptions.h"
+
+namespace {
+
+// Returns the name of cv::VideoAccelerationType.
+wxString GetAccelerationName(int acceleration)
+{
+    static const char* const names[] = { "none", "any", "D3D11", "VAAPI", "MFX" };
+
+    if ( acceleration >= 0 && acceleration < static_cast<int>(WXSIZEOF(names)) )
+        return names[acceleration];
+
+    return wxString::Format("%d", acceleration);
+}
+
+} // unnamed namespace
+
+//
+// VideoCaptureOptions
+//
+
+std::vector<int> VideoCaptureOptions::GetOpenParams() const
+{
+    std::vector<int> params;
+
+#if VIDEOCAPTURE_HAS_THREAD_COUNT
+    if ( threadCount != Default )
+    {
+        params.push_back(cv::CAP_PROP_N_THREADS);
+        params.push_back(threadCount);
+    }
+#endif
+
+#if VIDEOCAPTURE_HAS_OPEN_PARAMS
+    if ( hwAcceleration != Default )
+    {
+        params.push_back(cv::CAP_PROP_HW_ACCELERATION);
+        params.push_back(hwAcceleration);
+    }
+#endif
+
+    return params;
+}
+
+wxString VideoCaptureOptions::ToString() const
+{
+    wxString str;
+
+    str.Printf("backend %s", GetVideoCaptureBackendName(backend));
+
+    if ( threadCount == 0 )
+        str += ", decoder threads: all CPU cores";
+    else if ( threadCount != Default )
+        str += wxString::Format(", decoder threads: %d", threadCount);
+
+    if ( hwAcceleration != Default )
+        str += wxString::Format(", hardware acceleration: %s", GetAccelerationName(hwAcceleration));
+
+    if ( bufferSize > 0 )
+        str += wxString::Format(", buffer: %d frame(s)", bufferSize);
+
+    return str;
+}
+
+wxString GetVideoCaptureBackendName(int backend)
+{
+    if ( backend == cv::CAP_ANY )
+        return "Any";
+
+    return wxString(cv::videoio_registry::getBackendName(static_cast<cv::VideoCaptureAPIs>(backend)));
+}
+
+std::vector<int> GetAvailableVideoCaptureBackends(bool forCameras)
+{
+    const std::vector<cv::VideoCaptureAPIs> apis = forCameras
+        ? cv::videoio_registry::getCameraBackends() : cv::videoio_registry::getStreamBackends();
+
+    return std::vector<int>(apis.begin(), apis.end());
+}
+
+bool OpenVideoCapture(cv::VideoCapture& capture, const wxString& source,
+                      const VideoCaptureOptions& options, long openTimeoutMs)
+{
+    bool opened = false;
+
+#if VIDEOCAPTURE_HAS_OPEN_PARAMS
+    // The backend refuses to open with a parameter it does not support,
+    // camera backends do not support any of these.
+    if ( source.empty() )
+    {
+        opened = capture.open(0, options.backend);
+    }
+    else
+    {
+        std::vector<int> params = options.GetOpenParams();
+
+        // Without it, the backend may block for much longer
+        // than the user is willing to wait.
+        if ( openTimeoutMs > 0 )
+        {
+            params.push_back(cv::CAP_PROP_OPEN_TIMEOUT_MSEC);
+            params.push_back(static_cast<int>(openTimeoutMs));
+        }
+
+        opened = capture.open(source.ToStdString(), options.backend, params);
+    }
+#else
+    wxUnusedVar(openTimeoutMs);
+
+    if ( source.empty() )
+        opened = capture.open(0, options.backend);
+    else
+        opened = capture.open(source.ToStdString(), options.backend);
+#endif
+
+    if ( opened && options.bufferSize > 0 )
+        capture.set(cv::CAP_PROP_BUFFERSIZE, options.bufferSize);
+
+    return opened;
+}
+
+wxArrayString GetVideoCaptureReportedOptions(cv::VideoCapture& capture)
+{
+    wxArrayString options;
+    double        value = 0.;
+
+    // the backends return 0 for the properties they do not support
+#if VIDEOCAPTURE_HAS_THREAD_COUNT
+    value = capture.get(cv::CAP_PROP_N_THREADS);
+    if ( value > 0. )
+        options.push_back(wxString::Format("Decoder threads: %.0f", value));
+#endif
+
+#if VIDEOCAPTURE_HAS_OPEN_PARAMS
+    value = capture.get(cv::CAP_PROP_HW_ACCELERATION);
+    if ( value > 0. )
+        options.push_back(wxString::Format("Hardware acceleration: %s", GetAccelerationName(static_cast<int>(value))));
+#endif
+
+    value = capture.get(cv::CAP_PROP_BUFFERSIZE);
+    if ( value > 0. )
+        options.push_back(wxString::Format("Buffer: %.0f frame(s)", value));
+
+    return options;
+}
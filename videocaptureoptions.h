@@ -0,0 +1,97 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        videocaptureoptions.h
+// Purpose:     Opens cv::VideoCapture with backend and decoder options
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef VIDEOCAPTUREOPTIONS_H
+#define VIDEOCAPTUREOPTIONS_H
+
+#include <vector>
+
+#include <wx/arrstr.h>
+#include <wx/string.h>
+
+#include <opencv2/videoio.hpp>
+
+// OpenCV 4.5.2 added passing parameters to VideoCapture when opening it,
+// without them, only the backend can be chosen.
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && (CV_VERSION_MINOR > 5 || (CV_VERSION_MINOR == 5 && CV_VERSION_REVISION >= 2)))
+    #define VIDEOCAPTURE_HAS_OPEN_PARAMS 1
+#else
+    #define VIDEOCAPTURE_HAS_OPEN_PARAMS 0
+#endif
+
+// CAP_PROP_N_THREADS is available since OpenCV 4.6.0.
+#if CV_VERSION_MAJOR > 4 || (CV_VERSION_MAJOR == 4 && CV_VERSION_MINOR >= 6)
+    #define VIDEOCAPTURE_HAS_THREAD_COUNT 1
+#else
+    #define VIDEOCAPTURE_HAS_THREAD_COUNT 0
+#endif
+
+/**
+    How to open a video file, stream, or camera. The defaults
+    leave everything to OpenCV, i.e., are the same as opening
+    VideoCapture without any options.
+
+    threadCount and hwAcceleration are passed to the backend when opening.
+    OpenCV refuses to open a VideoCapture with a parameter its backend
+    does not use, so with a backend not supporting one of them opening
+    fails (with cv::CAP_ANY, OpenCV tries the other backends instead).
+    Camera backends support neither, OpenVideoCapture() therefore
+    does not pass them when opening a camera. bufferSize is set
+    after opening, a backend not supporting it ignores it.
+    The values the opened VideoCapture actually uses can be
+    obtained with GetVideoCaptureReportedOptions().
+*/
+struct VideoCaptureOptions
+{
+    enum
+    {
+        Default = -1, // for threadCount and hwAcceleration
+    };
+
+    // cv::VideoCaptureAPIs, e.g., cv::CAP_FFMPEG or cv::CAP_GSTREAMER,
+    // cv::CAP_ANY lets OpenCV choose
+    int  backend{cv::CAP_ANY};
+    // Decoder threads, 0 means as many as there are CPU cores.
+    // Needs OpenCV 4.6 and is supported only by the FFmpeg backend.
+    int  threadCount{Default};
+    // cv::VideoAccelerationType, e.g., cv::VIDEO_ACCELERATION_NONE.
+    // Needs OpenCV 4.5.2, supported by FFmpeg, GStreamer, and MSMF backends.
+    int  hwAcceleration{Default};
+    // Number of frames the backend buffers, 0 means the backend's default.
+    // 1 minimizes the latency of cameras, set after opening.
+    int  bufferSize{0};
+
+    // Returns the parameters to pass to VideoCapture::open(),
+    // without CAP_PROP_OPEN_TIMEOUT_MSEC.
+    std::vector<int> GetOpenParams() const;
+
+    // Returns a description of the options, e.g., for the Properties dialog.
+    wxString ToString() const;
+};
+
+// Returns the name of the backend, "Any" for cv::CAP_ANY.
+wxString GetVideoCaptureBackendName(int backend);
+
+// Returns the backends OpenCV was built with which can open files and streams
+// (forCameras is false) or cameras (forCameras is true).
+std::vector<int> GetAvailableVideoCaptureBackends(bool forCameras);
+
+// Opens the video file or stream or, when source is empty, the default camera.
+// openTimeoutMs is passed to the backend when not 0 and OpenCV supports it.
+// For the camera, only the backend and bufferSize of options are used
+// and openTimeoutMs is ignored, as camera backends do not support them.
+// Returns false if capture could not be opened. The backend may throw.
+bool OpenVideoCapture(cv::VideoCapture& capture, const wxString& source,
+                      const VideoCaptureOptions& options, long openTimeoutMs = 0);
+
+// Returns the options the backend of the opened capture reports,
+// as lines of text. The backends report only some of them, if any.
+wxArrayString GetVideoCaptureReportedOptions(cv::VideoCapture& capture);
+
+#endif // #ifndef VIDEOCAPTUREOPTIONS_H
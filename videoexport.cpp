@@ -0,0 +1,291 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        videoexport.cpp
+// Purpose:     Exports a range of video frames with processing applied
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <wx/wx.h>
+
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+
+#include "videoexport.h"
+
+VideoExportJob::VideoExportJob(const VideoExportOptions& options, ProgressFunction progress)
+    : m_options(options), m_progressFunction(std::move(progress))
+{
+}
+
+VideoExportJob::~VideoExportJob()
+{
+    Cancel();
+    Wait();
+}
+
+bool VideoExportJob::Start(wxString& errorMessage)
+{
+    wxCHECK(!m_readerThread.joinable(), false);
+
+    // lastFrame is checked against the video length in OpenInput()
+    if ( m_options.firstFrame < 0 || (m_options.lastFrame >= 0 && m_options.firstFrame > m_options.lastFrame) )
+    {
+        errorMessage.Printf("Invalid range of frames to export (%d - %d).",
+            m_options.firstFrame, m_options.lastFrame);
+        return false;
+    }
+
+    m_progress = VideoExportProgress();
+    if ( m_options.lastFrame >= 0 )
+        m_progress.frameCount = m_options.lastFrame - m_options.firstFrame + 1;
+
+    m_processingChain.reset(new FrameProcessingChain(
+        [this](FrameProcessingChain::Frame& frame) { OnFrameProcessed(frame); },
+        m_options.workerCount));
+    m_processingChain->SetStages(m_options.stages);
+
+    m_startTicks = cv::getTickCount();
+    m_readerThread = std::thread(&VideoExportJob::ReaderEntry, this);
+    m_writerThread = std::thread(&VideoExportJob::WriterEntry, this);
+
+    return true;
+}
+
+void VideoExportJob::Cancel()
+{
+    m_cancelled = true;
+
+    // wake up the threads waiting for the queue
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+    }
+    m_queueNotEmpty.notify_all();
+    m_queueNotFull.notify_all();
+}
+
+void VideoExportJob::Wait()
+{
+    if ( m_readerThread.joinable() )
+        m_readerThread.join();
+    if ( m_writerThread.joinable() )
+        m_writerThread.join();
+}
+
+VideoExportProgress VideoExportJob::GetProgress() const
+{
+    std::lock_guard<std::mutex> lock(m_progressMutex);
+
+    return m_progress;
+}
+
+bool VideoExportJob::OpenInput()
+{
+    try
+    {
+        m_capture.reset(new cv::VideoCapture);
+        if ( !OpenVideoCapture(*m_capture, m_options.inputFileName, m_options.captureOptions) )
+        {
+            Fail(wxString::Format("Could not open video '%s' with %s.",
+                m_options.inputFileName, m_options.captureOptions.ToString()));
+            return false;
+        }
+
+        const int frameCount = static_cast<int>(m_capture->get(cv::CAP_PROP_FRAME_COUNT));
+
+        if ( m_options.lastFrame < 0 || m_options.lastFrame >= frameCount )
+            m_options.lastFrame = frameCount - 1;
+
+        if ( m_options.firstFrame > m_options.lastFrame )
+        {
+            Fail(wxString::Format("Invalid range of frames to export (%d - %d).",
+                m_options.firstFrame, m_options.lastFrame));
+            return false;
+        }
+
+        if ( m_options.firstFrame > 0 )
+            m_capture->set(cv::CAP_PROP_POS_FRAMES, m_options.firstFrame);
+
+        // The writer thread reads it only after it gets the first frame.
+        m_fps = m_options.fps > 0. ? m_options.fps : m_capture->get(cv::CAP_PROP_FPS);
+        if ( m_fps <= 0. )
+            m_fps = 25.; // some containers do not store the frame rate
+    }
+    catch ( const std::exception& e )
+    {
+        Fail(wxString::Format("Could not open video '%s': %s", m_options.inputFileName, e.what()));
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(m_progressMutex);
+
+    m_progress.frameCount = m_options.lastFrame - m_options.firstFrame + 1;
+
+    return true;
+}
+
+void VideoExportJob::ReaderEntry()
+{
+    const bool opened = OpenInput();
+
+    for ( int frameNumber = m_options.firstFrame;
+          opened && frameNumber <= m_options.lastFrame && !m_cancelled;
+          ++frameNumber )
+    {
+        cv::Mat frame;
+
+        try
+        {
+            // the reported frame count may be only an estimate
+            if ( !m_capture->read(frame) || frame.empty() )
+                break;
+        }
+        catch ( const std::exception& e )
+        {
+            Fail(wxString::Format("Could not read frame %d: %s", frameNumber, e.what()));
+            break;
+        }
+
+        // the frame number is passed through as timeGet
+        m_processingChain->Submit(frame, frameNumber, true);
+    }
+
+    m_processingChain->WaitUntilDelivered();
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+
+        m_inputFinished = true;
+    }
+    m_queueNotEmpty.notify_all();
+}
+
+void VideoExportJob::OnFrameProcessed(FrameProcessingChain::Frame& frame)
+{
+    if ( !frame.errorMessage.empty() )
+    {
+        Fail(frame.errorMessage);
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_queueMutex);
+
+    // This blocks the delivery of further frames, so the workers
+    // stop taking new frames too once the frames in flight are done.
+    m_queueNotFull.wait(lock, [this] { return m_cancelled || m_queue.size() < m_options.queueSize; });
+
+    if ( m_cancelled )
+        return;
+
+    m_queue.push_back(frame.matBitmap);
+    lock.unlock();
+    m_queueNotEmpty.notify_one();
+}
+
+void VideoExportJob::WriterEntry()
+{
+    int64  lastReportTicks = m_startTicks;
+    int    framesWritten = 0;
+    double bytesWritten = 0.;
+
+    for ( ;; )
+    {
+        cv::Mat frame;
+
+        {
+            std::unique_lock<std::mutex> lock(m_queueMutex);
+
+            m_queueNotEmpty.wait(lock, [this] { return m_cancelled || m_inputFinished || !m_queue.empty(); });
+
+            if ( m_cancelled || m_queue.empty() )
+                break;
+
+            frame = m_queue.front();
+            m_queue.pop_front();
+        }
+        m_queueNotFull.notify_one();
+
+        try
+        {
+            if ( !m_writer )
+            {
+                const int fourCC = m_options.fourCC ? m_options.fourCC : cv::VideoWriter::fourcc('M', 'J', 'P', 'G');
+
+                m_writer.reset(new cv::VideoWriter(m_options.outputFileName.ToStdString(),
+                                                   fourCC, m_fps, frame.size(), frame.channels() != 1));
+                if ( !m_writer->isOpened() )
+                {
+                    Fail(wxString::Format("Could not create video '%s'.", m_options.outputFileName));
+                    break;
+                }
+            }
+
+            if ( frame.depth() != CV_8U )
+            {
+                Fail("Only 8-bit frames can be written.");
+                break;
+            }
+
+            m_writer->write(frame);
+        }
+        catch ( const std::exception& e )
+        {
+            Fail(wxString::Format("Could not write frame: %s", e.what()));
+            break;
+        }
+
+        framesWritten++;
+        bytesWritten += static_cast<double>(frame.total() * frame.elemSize());
+
+        const int64 ticks = cv::getTickCount();
+
+        if ( (ticks - lastReportTicks) * 1000. / cv::getTickFrequency() >= 100. )
+        {
+            lastReportTicks = ticks;
+            ReportProgress(framesWritten, bytesWritten, false);
+        }
+    }
+
+    if ( m_writer )
+        m_writer->release();
+
+    ReportProgress(framesWritten, bytesWritten, true);
+}
+
+void VideoExportJob::Fail(const wxString& errorMessage)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_progressMutex);
+
+        // the first error is usually the most useful one
+        if ( m_progress.errorMessage.empty() )
+            m_progress.errorMessage = errorMessage;
+    }
+
+    Cancel();
+}
+
+void VideoExportJob::ReportProgress(int framesWritten, double bytesWritten, bool finished)
+{
+    VideoExportProgress progress;
+
+    {
+        std::lock_guard<std::mutex> lock(m_progressMutex);
+
+        m_progress.framesWritten = framesWritten;
+        m_progress.elapsedMs = (cv::getTickCount() - m_startTicks) * 1000. / cv::getTickFrequency();
+        if ( m_progress.elapsedMs > 0. )
+        {
+            m_progress.fps = framesWritten * 1000. / m_progress.elapsedMs;
+            m_progress.MBPerSec = bytesWritten / (1024. * 1024.) * 1000. / m_progress.elapsedMs;
+        }
+        m_progress.finished = finished;
+        m_progress.cancelled = finished && m_cancelled && m_progress.errorMessage.empty();
+
+        progress = m_progress;
+    }
+
+    if ( m_progressFunction )
+        m_progressFunction(progress);
+}
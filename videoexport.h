@@ -0,0 +1,133 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        videoexport.h
+// Purpose:     Exports a range of video frames with processing applied
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef VIDEOEXPORT_H
+#define VIDEOEXPORT_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <wx/string.h>
+
+#include "frameprocessingchain.h"
+#include "videocaptureoptions.h"
+
+// forward declarations
+namespace cv
+{
+    class VideoCapture;
+    class VideoWriter;
+}
+
+struct VideoExportOptions
+{
+    wxString inputFileName;
+    // used for opening the input video
+    VideoCaptureOptions captureOptions;
+    wxString outputFileName;
+    int      firstFrame{0};
+    int      lastFrame{-1};    // inclusive, -1 means the last frame of the video
+    int      fourCC{0};        // 0 means MJPG
+    double   fps{0.0};         // 0 means the same as the input video
+    size_t   workerCount{0};   // 0 means the number of hardware threads
+    size_t   queueSize{8};     // maximum number of frames waiting for the writer
+    // Applied to each frame before it is written, can be empty.
+    std::vector<FrameProcessingStage> stages;
+};
+
+struct VideoExportProgress
+{
+    int      framesWritten{0};
+    int      frameCount{0};    // frames in the range to export
+    double   elapsedMs{0.0};
+    double   fps{0.0};         // frames written per second
+    double   MBPerSec{0.0};    // uncompressed frame data written per second
+    bool     finished{false};
+    bool     cancelled{false};
+    wxString errorMessage;     // not empty if the export failed
+};
+
+/**
+    Reads a range of frames from a video file, processes them
+    on a pool of worker threads (see FrameProcessingChain),
+    and writes them in the original order with cv::VideoWriter.
+
+    There are three stages running in parallel: reading (and decoding)
+    in a reader thread, processing in the worker threads, and writing
+    (and encoding) in a writer thread. The writer is fed through
+    a bounded queue, so that the memory use does not grow when
+    it is slower than the rest: the workers then wait for the writer
+    and the reader waits for the workers.
+
+    The input video is opened with its own cv::VideoCapture (in the reader
+    thread, as opening and seeking may take long), so that the export
+    does not interfere with other uses of the video.
+*/
+class VideoExportJob
+{
+public:
+    // Called from the writer thread, at most every 100 ms,
+    // and always once after the export finished.
+    typedef std::function<void(const VideoExportProgress& progress)> ProgressFunction;
+
+    VideoExportJob(const VideoExportOptions& options, ProgressFunction progress);
+    // Cancels the export if it is still running.
+    ~VideoExportJob();
+
+    // Starts the export, does not wait for it to finish. Fails only
+    // when the options are invalid. The input video is opened by the reader
+    // thread and the output video when the first frame is to be written
+    // (its size and number of channels depend on the processing),
+    // errors are reported via progress.
+    bool Start(wxString& errorMessage);
+
+    void Cancel();
+    // Blocks until the export has finished.
+    void Wait();
+
+    VideoExportProgress GetProgress() const;
+
+private:
+    VideoExportOptions                    m_options;
+    ProgressFunction                      m_progressFunction;
+
+    std::unique_ptr<cv::VideoCapture>     m_capture;
+    std::unique_ptr<cv::VideoWriter>      m_writer;
+    std::unique_ptr<FrameProcessingChain> m_processingChain;
+    std::thread                           m_readerThread;
+    std::thread                           m_writerThread;
+    std::atomic<bool>                     m_cancelled{false};
+    double                                m_fps{0.0};
+    int64                                 m_startTicks{0};
+
+    // the queue of processed frames for the writer
+    std::mutex                            m_queueMutex;
+    std::condition_variable               m_queueNotEmpty;
+    std::condition_variable               m_queueNotFull;
+    std::deque<cv::Mat>                   m_queue;
+    bool                                  m_inputFinished{false};
+
+    mutable std::mutex                    m_progressMutex;
+    VideoExportProgress                   m_progress;
+
+    void ReaderEntry();
+    bool OpenInput();
+    void WriterEntry();
+    void OnFrameProcessed(FrameProcessingChain::Frame& frame);
+    void Fail(const wxString& errorMessage);
+    void ReportProgress(int framesWritten, double bytesWritten, bool finished);
+};
+
+#endif // #ifndef VIDEOEXPORT_H
@@ -0,0 +1,393 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        videothumbnails.cpp
+// Purpose:     Creates thumbnails of a video in the background
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <wx/wx.h>
+#include <wx/file.h>
+#include <wx/filename.h>
+
+#include <algorithm>
+#include <cstring>
+
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+
+#include "videothumbnails.h"
+
+namespace {
+
+// The cache file starts with the magic and version,
+// followed by the CacheKey fields, the frame count of the video,
+// and then for each thumbnail its frame number and its JPEG data size
+// and data. All the numbers are little-endian.
+const char     cacheMagic[4] = { 'W', 'O', 'V', 'T' };
+const wxUint32 cacheVersion  = 1;
+
+const int      cacheJPEGQuality = 80;
+
+// When the next thumbnail is farther than this, seek instead of grabbing.
+const int      maxFramesToGrab = 48;
+
+class CacheWriter
+{
+public:
+    void Write(const void* data, size_t size)
+    {
+        const char* bytes = static_cast<const char*>(data);
+
+        m_buffer.insert(m_buffer.end(), bytes, bytes + size);
+    }
+
+    void WriteUint32(wxUint32 value)
+    {
+        value = wxUINT32_SWAP_ON_BE(value);
+        Write(&value, sizeof(value));
+    }
+
+    void WriteUint64(wxUint64 value)
+    {
+        value = wxUINT64_SWAP_ON_BE(value);
+        Write(&value, sizeof(value));
+    }
+
+    const std::vector<char>& GetBuffer() const { return m_buffer; }
+
+private:
+    std::vector<char> m_buffer;
+};
+
+class CacheReader
+{
+public:
+    CacheReader(const std::vector<char>& buffer) : m_buffer(buffer) {}
+
+    bool Read(void* data, size_t size)
+    {
+        if ( m_buffer.size() - m_position < size )
+            return false;
+
+        memcpy(data, m_buffer.data() + m_position, size);
+        m_position += size;
+        return true;
+    }
+
+    bool ReadUint32(wxUint32& value)
+    {
+        if ( !Read(&value, sizeof(value)) )
+            return false;
+
+        value = wxUINT32_SWAP_ON_BE(value);
+        return true;
+    }
+
+    bool ReadUint64(wxUint64& value)
+    {
+        if ( !Read(&value, sizeof(value)) )
+            return false;
+
+        value = wxUINT64_SWAP_ON_BE(value);
+        return true;
+    }
+
+    bool AtEnd() const { return m_position == m_buffer.size(); }
+
+    // Returns nullptr if there are not enough data.
+    const uchar* Skip(size_t size)
+    {
+        if ( m_buffer.size() - m_position < size )
+            return nullptr;
+
+        const uchar* data = reinterpret_cast<const uchar*>(m_buffer.data() + m_position);
+
+        m_position += size;
+        return data;
+    }
+
+private:
+    const std::vector<char>& m_buffer;
+    size_t                   m_position{0};
+};
+
+// Returns a BGR CV_8UC3 Mat with the given height.
+cv::Mat CreateThumbnail(const cv::Mat& frame, int height)
+{
+    cv::Mat bgr, thumbnail;
+
+    if ( frame.channels() == 1 )
+        cv::cvtColor(frame, bgr, cv::COLOR_GRAY2BGR);
+    else if ( frame.channels() == 4 )
+        cv::cvtColor(frame, bgr, cv::COLOR_BGRA2BGR);
+    else
+        bgr = frame;
+
+    if ( bgr.depth() != CV_8U )
+        bgr.convertTo(bgr, CV_8U);
+
+    const int width = std::max(1, cvRound(bgr.cols * static_cast<double>(height) / bgr.rows));
+
+    cv::resize(bgr, thumbnail, cv::Size(width, height), 0, 0, cv::INTER_AREA);
+    return thumbnail;
+}
+
+} // unnamed namespace
+
+VideoThumbnailJob::VideoThumbnailJob(const VideoThumbnailOptions& options,
+                                     ThumbnailFunction thumbnailFunction, FinishedFunction finishedFunction)
+    : m_options(options),
+      m_thumbnailFunction(std::move(thumbnailFunction)),
+      m_finishedFunction(std::move(finishedFunction))
+{
+    wxASSERT(m_options.thumbnailCount > 0);
+    wxASSERT(m_options.thumbnailHeight > 0);
+}
+
+VideoThumbnailJob::~VideoThumbnailJob()
+{
+    Cancel();
+    Wait();
+}
+
+void VideoThumbnailJob::Start()
+{
+    wxCHECK_RET(!m_thread.joinable(), "The job was already started");
+
+    m_thread = std::thread(&VideoThumbnailJob::Entry, this);
+}
+
+void VideoThumbnailJob::Cancel()
+{
+    m_cancelled = true;
+}
+
+void VideoThumbnailJob::Wait()
+{
+    if ( m_thread.joinable() )
+        m_thread.join();
+}
+
+wxString VideoThumbnailJob::GetCacheFileName(const wxString& videoFileName)
+{
+    return videoFileName + ".thumbs";
+}
+
+void VideoThumbnailJob::Entry()
+{
+    const int64                 startTicks = cv::getTickCount();
+    VideoThumbnailsResult       result;
+    std::vector<VideoThumbnail> thumbnails;
+    CacheKey                    key;
+    const bool                  hasKey = m_options.useCache && GetCacheKey(key);
+
+    if ( !hasKey || !LoadCache(key, result) )
+    {
+        if ( CreateThumbnails(result, thumbnails) && hasKey && !m_cancelled )
+            SaveCache(key, result.frameCount, thumbnails);
+    }
+
+    result.elapsedMs = (cv::getTickCount() - startTicks) * 1000. / cv::getTickFrequency();
+    result.cancelled = m_cancelled && result.errorMessage.empty();
+
+    if ( m_finishedFunction )
+        m_finishedFunction(result);
+}
+
+bool VideoThumbnailJob::GetCacheKey(CacheKey& key) const
+{
+    const wxFileName   fileName(m_options.fileName);
+    const wxULongLong  fileSize = fileName.GetSize();
+    const wxDateTime   modificationTime = fileName.GetModificationTime();
+
+    if ( fileSize == wxInvalidSize || !modificationTime.IsValid() )
+        return false;
+
+    key.fileSize = fileSize.GetValue();
+    key.modificationTime = modificationTime.GetValue().GetValue();
+    key.thumbnailCount = m_options.thumbnailCount;
+    key.thumbnailHeight = m_options.thumbnailHeight;
+
+    return true;
+}
+
+bool VideoThumbnailJob::LoadCache(const CacheKey& key, VideoThumbnailsResult& result)
+{
+    const wxString cacheFileName = GetCacheFileName(m_options.fileName);
+
+    if ( !wxFileName::FileExists(cacheFileName) )
+        return false;
+
+    wxLogNull          logNo; // a missing or invalid cache is not an error
+    wxFile             file(cacheFileName);
+    const wxFileOffset length = file.IsOpened() ? file.Length() : wxInvalidOffset;
+
+    if ( length == wxInvalidOffset )
+        return false;
+
+    std::vector<char> buffer(static_cast<size_t>(length));
+
+    if ( file.Read(buffer.data(), buffer.size()) != static_cast<ssize_t>(buffer.size()) )
+        return false;
+
+    CacheReader reader(buffer);
+    char        magic[sizeof(cacheMagic)];
+    wxUint32    version = 0, thumbnailCount = 0, thumbnailHeight = 0, frameCount = 0;
+    wxUint64    fileSize = 0, modificationTime = 0;
+
+    if ( !reader.Read(magic, sizeof(magic)) || memcmp(magic, cacheMagic, sizeof(magic)) != 0
+         || !reader.ReadUint32(version) || version != cacheVersion
+         || !reader.ReadUint64(fileSize) || !reader.ReadUint64(modificationTime)
+         || !reader.ReadUint32(thumbnailCount) || !reader.ReadUint32(thumbnailHeight)
+         || !reader.ReadUint32(frameCount) )
+    {
+        return false;
+    }
+
+    if ( fileSize != key.fileSize
+         || static_cast<wxInt64>(modificationTime) != key.modificationTime
+         || static_cast<wxInt32>(thumbnailCount) != key.thumbnailCount
+         || static_cast<wxInt32>(thumbnailHeight) != key.thumbnailHeight )
+    {
+        return false;
+    }
+
+    std::vector<VideoThumbnail> thumbnails;
+
+    // the video may have fewer frames than thumbnails requested
+    while ( thumbnails.size() < thumbnailCount && !reader.AtEnd() )
+    {
+        VideoThumbnail thumbnail;
+        wxUint32       frameNumber = 0, dataSize = 0;
+        const uchar*   data = nullptr;
+
+        if ( !reader.ReadUint32(frameNumber) || !reader.ReadUint32(dataSize)
+             || (data = reader.Skip(dataSize)) == nullptr )
+        {
+            return false;
+        }
+
+        thumbnail.index = static_cast<int>(thumbnails.size());
+        thumbnail.frameNumber = static_cast<int>(frameNumber);
+        thumbnail.matBitmap = cv::imdecode(cv::Mat(1, static_cast<int>(dataSize), CV_8UC1, const_cast<uchar*>(data)),
+                                           cv::IMREAD_COLOR);
+        if ( thumbnail.matBitmap.empty() )
+            return false;
+
+        thumbnails.push_back(thumbnail);
+    }
+
+    if ( m_thumbnailFunction )
+    {
+        for ( const auto& thumbnail : thumbnails )
+            m_thumbnailFunction(thumbnail);
+    }
+
+    result.thumbnailCount = static_cast<int>(thumbnails.size());
+    result.frameCount = static_cast<int>(frameCount);
+    result.fromCache = true;
+
+    return true;
+}
+
+bool VideoThumbnailJob::SaveCache(const CacheKey& key, int frameCount,
+                                  const std::vector<VideoThumbnail>& thumbnails) const
+{
+    CacheWriter      writer;
+    std::vector<int> JPEGParams{ cv::IMWRITE_JPEG_QUALITY, cacheJPEGQuality };
+
+    writer.Write(cacheMagic, sizeof(cacheMagic));
+    writer.WriteUint32(cacheVersion);
+    writer.WriteUint64(key.fileSize);
+    writer.WriteUint64(static_cast<wxUint64>(key.modificationTime));
+    writer.WriteUint32(static_cast<wxUint32>(key.thumbnailCount));
+    writer.WriteUint32(static_cast<wxUint32>(key.thumbnailHeight));
+    writer.WriteUint32(static_cast<wxUint32>(frameCount));
+
+    for ( const auto& thumbnail : thumbnails )
+    {
+        std::vector<uchar> data;
+
+        if ( !cv::imencode(".jpg", thumbnail.matBitmap, data, JPEGParams) )
+            return false;
+
+        writer.WriteUint32(static_cast<wxUint32>(thumbnail.frameNumber));
+        writer.WriteUint32(static_cast<wxUint32>(data.size()));
+        writer.Write(data.data(), data.size());
+    }
+
+    // Written to a temporary file first, so that a reader
+    // never sees a partially written cache.
+    wxLogNull  logNo;
+    wxTempFile file(GetCacheFileName(m_options.fileName));
+    const std::vector<char>& buffer = writer.GetBuffer();
+
+    return file.IsOpened() && file.Write(buffer.data(), buffer.size()) && file.Commit();
+}
+
+bool VideoThumbnailJob::CreateThumbnails(VideoThumbnailsResult& result, std::vector<VideoThumbnail>& thumbnails)
+{
+    try
+    {
+        cv::VideoCapture capture;
+
+        if ( !OpenVideoCapture(capture, m_options.fileName, m_options.captureOptions) )
+        {
+            result.errorMessage.Printf("Could not open video '%s' with %s.",
+                                       m_options.fileName, m_options.captureOptions.ToString());
+            return false;
+        }
+
+        const int frameCount = static_cast<int>(capture.get(cv::CAP_PROP_FRAME_COUNT));
+        const int thumbnailCount = std::min(m_options.thumbnailCount, frameCount);
+        int       nextFrameNumber = 0; // of the frame grab() would get
+        cv::Mat   frame;
+
+        result.frameCount = frameCount;
+
+        for ( int i = 0; i < thumbnailCount && !m_cancelled; ++i )
+        {
+            // in the middle of the part of the video the thumbnail represents
+            const int frameNumber = static_cast<int>((i + 0.5) * frameCount / thumbnailCount);
+
+            if ( frameNumber - nextFrameNumber > maxFramesToGrab )
+            {
+                capture.set(cv::CAP_PROP_POS_FRAMES, frameNumber);
+                nextFrameNumber = frameNumber;
+            }
+
+            while ( nextFrameNumber < frameNumber && !m_cancelled && capture.grab() )
+                ++nextFrameNumber;
+
+            // the reported frame count may be only an estimate
+            if ( m_cancelled || nextFrameNumber < frameNumber
+                 || !capture.grab() || !capture.retrieve(frame) || frame.empty() )
+            {
+                break;
+            }
+            ++nextFrameNumber;
+
+            VideoThumbnail thumbnail;
+
+            thumbnail.index = i;
+            thumbnail.frameNumber = frameNumber;
+            thumbnail.matBitmap = CreateThumbnail(frame, m_options.thumbnailHeight);
+            thumbnails.push_back(thumbnail);
+
+            if ( m_thumbnailFunction )
+                m_thumbnailFunction(thumbnail);
+        }
+    }
+    catch ( const std::exception& e )
+    {
+        result.errorMessage.Printf("Could not create thumbnails: %s", e.what());
+        return false;
+    }
+
+    result.thumbnailCount = static_cast<int>(thumbnails.size());
+
+    return true;
+}
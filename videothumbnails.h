@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        videothumbnails.h
+// Purpose:     Creates thumbnails of a video in the background
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef VIDEOTHUMBNAILS_H
+#define VIDEOTHUMBNAILS_H
+
+#include <atomic>
+#include <functional>
+#include <thread>
+#include <vector>
+
+#include <wx/string.h>
+
+#include <opencv2/core.hpp>
+
+#include "videocaptureoptions.h"
+
+struct VideoThumbnailOptions
+{
+    wxString fileName;
+    // used for opening the video
+    VideoCaptureOptions captureOptions;
+    int      thumbnailCount{32};
+    int      thumbnailHeight{72};  // in pixels, the width keeps the aspect ratio
+    // Read the thumbnails from the cache file if it is up to date
+    // and write them to it after they were created.
+    bool     useCache{true};
+};
+
+struct VideoThumbnail
+{
+    int     index{0};
+    int     frameNumber{0};
+    cv::Mat matBitmap;             // always CV_8UC3 (BGR)
+};
+
+struct VideoThumbnailsResult
+{
+    int      thumbnailCount{0};    // created or loaded from the cache
+    int      frameCount{0};        // of the video
+    double   elapsedMs{0.0};
+    bool     fromCache{false};
+    bool     cancelled{false};
+    wxString errorMessage;         // not empty if the thumbnails could not be created
+};
+
+/**
+    Creates evenly spaced thumbnails of a video file in a worker thread.
+
+    The video is opened with its own cv::VideoCapture, so that
+    the job does not interfere with other uses of the video.
+    The frames between the thumbnails are skipped with grab(),
+    which does not convert them to BGR, or by seeking when they are
+    too many. Only the frames used for thumbnails are retrieved,
+    and they are immediately downscaled.
+
+    The thumbnails are stored in a cache file next to the video
+    (see GetCacheFileName()), as JPEGs. The cache is valid as long
+    as the size and modification time of the video and the options
+    do not change, then the thumbnails are just loaded from it.
+    Failing to write the cache (e.g., in a read-only folder) is not an error.
+*/
+class VideoThumbnailJob
+{
+public:
+    // Called from the worker thread for each thumbnail, in order of their indices.
+    typedef std::function<void(const VideoThumbnail& thumbnail)> ThumbnailFunction;
+    // Called from the worker thread once after the job has finished.
+    typedef std::function<void(const VideoThumbnailsResult& result)> FinishedFunction;
+
+    VideoThumbnailJob(const VideoThumbnailOptions& options,
+                      ThumbnailFunction thumbnailFunction, FinishedFunction finishedFunction);
+    // Cancels the job if it is still running.
+    ~VideoThumbnailJob();
+
+    // Starts the job, does not wait for it to finish.
+    void Start();
+
+    void Cancel();
+    // Blocks until the job has finished.
+    void Wait();
+
+    static wxString GetCacheFileName(const wxString& videoFileName);
+
+private:
+    // Identifies the version of the video the thumbnails were created from.
+    struct CacheKey
+    {
+        wxUint64 fileSize{0};
+        wxInt64  modificationTime{0}; // ms since the epoch
+        wxInt32  thumbnailCount{0};
+        wxInt32  thumbnailHeight{0};
+    };
+
+    VideoThumbnailOptions m_options;
+    ThumbnailFunction     m_thumbnailFunction;
+    FinishedFunction      m_finishedFunction;
+    std::thread           m_thread;
+    std::atomic<bool>     m_cancelled{false};
+
+    void Entry();
+
+    bool GetCacheKey(CacheKey& key) const;
+    bool LoadCache(const CacheKey& key, VideoThumbnailsResult& result);
+    bool SaveCache(const CacheKey& key, int frameCount, const std::vector<VideoThumbnail>& thumbnails) const;
+
+    bool CreateThumbnails(VideoThumbnailsResult& result, std::vector<VideoThumbnail>& thumbnails);
+};
+
+#endif // #ifndef VIDEOTHUMBNAILS_H
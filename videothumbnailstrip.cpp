@@ -0,0 +1,181 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        videothumbnailstrip.cpp
+// Purpose:     Displays thumbnails of a video for navigation
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#include <wx/wx.h>
+#include <wx/dcbuffer.h>
+
+#include <algorithm>
+
+#include "videothumbnailstrip.h"
+
+wxDEFINE_EVENT(wxEVT_VIDEO_THUMBNAIL_STRIP, wxCommandEvent);
+
+wxVideoThumbnailStrip::wxVideoThumbnailStrip(wxWindow* parent)
+    : wxWindow(parent, wxID_ANY, wxDefaultPosition, wxDefaultSize, wxFULL_REPAINT_ON_RESIZE)
+{
+    SetBackgroundColour(*wxBLACK);
+    SetBackgroundStyle(wxBG_STYLE_PAINT);
+    SetCursor(wxCursor(wxCURSOR_HAND));
+
+    Bind(wxEVT_PAINT, &wxVideoThumbnailStrip::OnPaint, this);
+    Bind(wxEVT_SIZE, &wxVideoThumbnailStrip::OnSize, this);
+    Bind(wxEVT_LEFT_DOWN, &wxVideoThumbnailStrip::OnMouse, this);
+    Bind(wxEVT_MOTION, &wxVideoThumbnailStrip::OnMouse, this);
+}
+
+void wxVideoThumbnailStrip::Reset(int frameCount, int thumbnailCount)
+{
+    m_thumbnails.clear();
+    m_thumbnails.resize(std::max(0, thumbnailCount));
+    m_frameCount = frameCount;
+    m_currentFrame = 0;
+
+    Refresh();
+}
+
+void wxVideoThumbnailStrip::SetThumbnail(int index, const wxImage& image)
+{
+    wxCHECK_RET(index >= 0 && static_cast<size_t>(index) < m_thumbnails.size(), "Invalid thumbnail index");
+    wxCHECK_RET(image.IsOk(), "Invalid thumbnail image");
+
+    m_thumbnails[index].image = image;
+    m_thumbnails[index].bitmap = wxBitmap();
+
+    RefreshRect(GetCellRect(index), false);
+}
+
+void wxVideoThumbnailStrip::SetCurrentFrame(int frameNumber)
+{
+    if ( frameNumber == m_currentFrame )
+        return;
+
+    const int oldX = GetXOfFrame(m_currentFrame);
+    const int newX = GetXOfFrame(frameNumber);
+    const int height = GetClientSize().GetHeight();
+
+    m_currentFrame = frameNumber;
+
+    // the marker is drawn over the cells, repaint them under both positions
+    RefreshRect(wxRect(oldX - FromDIP(2), 0, FromDIP(5), height), false);
+    RefreshRect(wxRect(newX - FromDIP(2), 0, FromDIP(5), height), false);
+}
+
+wxRect wxVideoThumbnailStrip::GetCellRect(size_t index) const
+{
+    const wxSize clientSize = GetClientSize();
+    const size_t count = std::max<size_t>(1, m_thumbnails.size());
+    const int    left = static_cast<int>(clientSize.GetWidth() * index / count);
+    const int    right = static_cast<int>(clientSize.GetWidth() * (index + 1) / count);
+
+    return wxRect(left, 0, right - left, clientSize.GetHeight());
+}
+
+int wxVideoThumbnailStrip::GetFrameAtX(int x) const
+{
+    const int width = GetClientSize().GetWidth();
+
+    if ( m_frameCount <= 0 || width <= 0 )
+        return 0;
+
+    const int frameNumber = static_cast<int>(static_cast<double>(x) * m_frameCount / width);
+
+    return std::min(std::max(frameNumber, 0), m_frameCount - 1);
+}
+
+int wxVideoThumbnailStrip::GetXOfFrame(int frameNumber) const
+{
+    if ( m_frameCount <= 0 )
+        return 0;
+
+    // the middle of the part of the strip the frame is in
+    return static_cast<int>((frameNumber + 0.5) * GetClientSize().GetWidth() / m_frameCount);
+}
+
+wxSize wxVideoThumbnailStrip::DoGetBestClientSize() const
+{
+    return FromDIP(wxSize(64, 48));
+}
+
+void wxVideoThumbnailStrip::OnPaint(wxPaintEvent&)
+{
+    wxAutoBufferedPaintDC dc(this);
+
+    dc.SetBackground(*wxBLACK_BRUSH);
+    dc.Clear();
+
+    const wxRect updateRect = GetUpdateRegion().GetBox();
+
+    for ( size_t i = 0; i < m_thumbnails.size(); ++i )
+    {
+        const wxRect cellRect = GetCellRect(i);
+        Thumbnail&   thumbnail = m_thumbnails[i];
+
+        if ( !cellRect.Intersects(updateRect) )
+            continue;
+
+        if ( !thumbnail.image.IsOk() )
+        {
+            // not created yet
+            dc.SetPen(*wxTRANSPARENT_PEN);
+            dc.SetBrush(wxBrush(wxColour(48, 48, 48)));
+            dc.DrawRectangle(cellRect.Deflate(1));
+            continue;
+        }
+
+        // Scaled only when the size of the cell changes, the scaled
+        // thumbnail fits into the cell and keeps the aspect ratio.
+        if ( !thumbnail.bitmap.IsOk() )
+        {
+            const wxSize imageSize = thumbnail.image.GetSize();
+            const double scale = std::min(static_cast<double>(cellRect.GetWidth()) / imageSize.GetWidth(),
+                                          static_cast<double>(cellRect.GetHeight()) / imageSize.GetHeight());
+            const wxSize scaledSize(std::max(1, static_cast<int>(imageSize.GetWidth() * scale)),
+                                    std::max(1, static_cast<int>(imageSize.GetHeight() * scale)));
+
+            thumbnail.bitmap = wxBitmap(thumbnail.image.Scale(scaledSize.GetWidth(), scaledSize.GetHeight(),
+                                                              wxIMAGE_QUALITY_BILINEAR));
+        }
+
+        const wxSize bitmapSize = thumbnail.bitmap.GetSize();
+
+        dc.DrawBitmap(thumbnail.bitmap,
+                      cellRect.GetLeft() + (cellRect.GetWidth() - bitmapSize.GetWidth()) / 2,
+                      cellRect.GetTop() + (cellRect.GetHeight() - bitmapSize.GetHeight()) / 2, false);
+    }
+
+    if ( m_frameCount > 0 )
+    {
+        const int x = GetXOfFrame(m_currentFrame);
+
+        dc.SetPen(wxPen(*wxRED, FromDIP(3)));
+        dc.DrawLine(x, 0, x, GetClientSize().GetHeight());
+    }
+}
+
+void wxVideoThumbnailStrip::OnSize(wxSizeEvent& evt)
+{
+    for ( auto& thumbnail : m_thumbnails )
+        thumbnail.bitmap = wxBitmap();
+
+    evt.Skip();
+}
+
+void wxVideoThumbnailStrip::OnMouse(wxMouseEvent& evt)
+{
+    evt.Skip();
+
+    if ( m_frameCount <= 0 || !(evt.LeftDown() || evt.LeftIsDown()) )
+        return;
+
+    wxCommandEvent stripEvent(wxEVT_VIDEO_THUMBNAIL_STRIP, GetId());
+
+    stripEvent.SetEventObject(this);
+    stripEvent.SetInt(GetFrameAtX(evt.GetX()));
+    ProcessWindowEvent(stripEvent);
+}
@@ -0,0 +1,62 @@
+///////////////////////////////////////////////////////////////////////////////
+// Name:        videothumbnailstrip.h
+// Purpose:     Displays thumbnails of a video for navigation
+// Author:      PB
+// Created:     2026-10-18
+// Copyright:   (c) 2026 PB
+// Licence:     wxWindows licence
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef VIDEOTHUMBNAILSTRIP_H
+#define VIDEOTHUMBNAILSTRIP_H
+
+#include <vector>
+
+#include <wx/wx.h>
+
+// Sent when the user clicks or drags the mouse in the strip,
+// GetInt() returns the number of the frame under the mouse.
+wxDECLARE_EVENT(wxEVT_VIDEO_THUMBNAIL_STRIP, wxCommandEvent);
+
+// This class displays evenly spaced thumbnails of a video (see VideoThumbnailJob)
+// side by side, each one in a cell representing the same number of frames,
+// and marks the position of the current frame.
+// The thumbnails can be added one by one as they are created.
+
+class wxVideoThumbnailStrip : public wxWindow
+{
+public:
+    wxVideoThumbnailStrip(wxWindow* parent);
+
+    // Removes all thumbnails and sets the number of frames
+    // of the video and the number of thumbnails there will be.
+    void Reset(int frameCount, int thumbnailCount);
+
+    // index must be less than the thumbnail count passed to Reset().
+    void SetThumbnail(int index, const wxImage& image);
+
+    void SetCurrentFrame(int frameNumber);
+
+private:
+    struct Thumbnail
+    {
+        wxImage  image;
+        wxBitmap bitmap; // image scaled to the cell, created when needed
+    };
+
+    std::vector<Thumbnail> m_thumbnails;
+    int                    m_frameCount{0};
+    int                    m_currentFrame{0};
+
+    wxRect GetCellRect(size_t index) const;
+    int    GetFrameAtX(int x) const;
+    int    GetXOfFrame(int frameNumber) const;
+
+    wxSize DoGetBestClientSize() const override;
+
+    void OnPaint(wxPaintEvent&);
+    void OnSize(wxSizeEvent& evt);
+    void OnMouse(wxMouseEvent& evt);
+};
+
+#endif // #ifndef VIDEOTHUMBNAILSTRIP_H